@@ -0,0 +1,92 @@
+// Microbenchmark for decoding genomes into orderings with topoSort().
+//
+// The previous list based decode is kept here as a reference. Each decode is
+// checked against it, so this also verifies that the orderings are unchanged.
+
+#include <chrono>
+#include <cstdlib>
+#include <list>
+#include <random>
+#include <unordered_set>
+
+#include <fmt/format.h>
+
+#include "ga_core.h"
+
+GeneVec listTopoSort(const GeneVec& geneVec)
+{
+  std::list<GeneDependency> geneList;
+  int i = 0;
+  for (auto geneIdx : geneVec) {
+    geneList.push_back(GeneDependency(i, geneIdx));
+    ++i;
+  }
+
+  geneList.sort([](const GeneDependency& a, const GeneDependency& b) -> bool {
+    return a.geneDependency < b.geneDependency;
+  });
+
+  GeneVec orderingVec;
+  std::unordered_set<int> dependencySet;
+
+  while (geneList.size()) {
+    bool found = false;
+    auto itr = geneList.begin();
+    while (itr != geneList.end()) {
+      if (dependencySet.count(itr->geneDependency)) {
+        orderingVec.push_back(itr->gene);
+        dependencySet.insert(itr->gene);
+        itr = geneList.erase(itr);
+        found = true;
+      }
+      else {
+        ++itr;
+      }
+    }
+    if (!found) {
+      orderingVec.push_back(geneList.front().gene);
+      dependencySet.insert(geneList.front().gene);
+      geneList.pop_front();
+    }
+  }
+  return orderingVec;
+}
+
+template <typename F> double timeDecodes(const std::vector<GeneVec>& v, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  size_t checksum = 0;
+  for (auto& geneVec : v) {
+    checksum += f(geneVec)[0];
+  }
+  std::chrono::duration<double> sec = std::chrono::steady_clock::now() - start;
+  if (checksum == static_cast<size_t>(-1)) {
+    fmt::print("");
+  }
+  return sec.count() / v.size();
+}
+
+int main()
+{
+  std::default_random_engine randomEngine(1);
+  for (int nGenes : { 100, 1000, 10000 }) {
+    int nGenomes = nGenes >= 10000 ? 5 : 200;
+    std::uniform_int_distribution<> d(0, nGenes - 1);
+    std::vector<GeneVec> genomeVec(nGenomes);
+    for (auto& geneVec : genomeVec) {
+      for (int i = 0; i < nGenes; ++i) {
+        geneVec.push_back(d(randomEngine));
+      }
+      if (topoSort(geneVec) != listTopoSort(geneVec)) {
+        fmt::print(stderr, "Ordering mismatch at nGenes={}\n", nGenes);
+        return EXIT_FAILURE;
+      }
+    }
+    auto listSec = timeDecodes(genomeVec, listTopoSort);
+    auto heapSec = timeDecodes(genomeVec, topoSort);
+    fmt::print(
+        "nGenes={:>6} list={:>10.1f}us heap={:>8.1f}us speedup={:.1f}x\n",
+        nGenes, listSec * 1e6, heapSec * 1e6, listSec / heapSec);
+  }
+  return EXIT_SUCCESS;
+}
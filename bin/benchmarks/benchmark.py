@@ -8,6 +8,8 @@ import cpuinfo # pip install py-cpuinfo
 
 
 N_REPEAT = 10
+# Fixed seed, so that all runs check the same orderings
+SEED = 1
 BENCHMARKS_FILE_PATH = './benchmarks.txt'
 REL_BIN_PATH = '../striprouter'
 
@@ -46,6 +48,7 @@ def run():
         './' + bin_name,
         '--nogui', '--exitafter', '1000', '--checkpoint', '100',
         '--circuit', './circuits/benchmark.circuit',
+        '--seed', str(SEED),
     ], cwd=abs_dir_path)
 
 
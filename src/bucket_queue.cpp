@@ -0,0 +1,143 @@
+#include <cassert>
+
+#include "bucket_queue.h"
+
+BucketQueue::BucketQueue() : nBucketsMask_(0), curKey_(0), size_(0)
+{
+}
+
+// maxKeySpread is the largest difference between the key of a pushed node and
+// the lowest key in the queue. For Dijkstra, it's the highest edge cost.
+void BucketQueue::reset(int nNodes, int maxKeySpread)
+{
+  if (static_cast<int>(nextVec_.size()) != nNodes) {
+    nextVec_.resize(nNodes);
+    prevVec_.resize(nNodes);
+    keyVec_.resize(nNodes);
+  }
+  for (auto idx : usedBucketIdxVec_) {
+    headVec_[idx] = -1;
+  }
+  usedBucketIdxVec_.clear();
+  int nBuckets = 1;
+  while (nBuckets <= maxKeySpread) {
+    nBuckets <<= 1;
+  }
+  // The buckets beyond nBuckets are all empty, so a smaller window can use the
+  // start of a larger bucket vector.
+  if (nBuckets > static_cast<int>(headVec_.size())) {
+    headVec_.assign(nBuckets, -1);
+  }
+  nBucketsMask_ = nBuckets - 1;
+  curKey_ = 0;
+  size_ = 0;
+}
+
+bool BucketQueue::isEmpty()
+{
+  return !size_;
+}
+
+void BucketQueue::push(int node, int key)
+{
+  assert(key >= curKey_);
+  if (key - curKey_ > nBucketsMask_) {
+    grow(key - curKey_);
+  }
+  link(node, key);
+  ++size_;
+}
+
+void BucketQueue::decreaseKey(int node, int key)
+{
+  assert(key >= curKey_);
+  assert(key <= keyVec_[node]);
+  unlink(node);
+  link(node, key);
+}
+
+int BucketQueue::pop()
+{
+  assert(size_);
+  while (headVec_[bucketIdx(curKey_)] == -1) {
+    ++curKey_;
+  }
+  int node = headVec_[bucketIdx(curKey_)];
+  unlink(node);
+  --size_;
+  return node;
+}
+
+// Return the lowest key in the queue without removing the node.
+int BucketQueue::topKey()
+{
+  assert(size_);
+  while (headVec_[bucketIdx(curKey_)] == -1) {
+    ++curKey_;
+  }
+  return curKey_;
+}
+
+//
+// Private
+//
+
+void BucketQueue::link(int node, int key)
+{
+  auto& head = headVec_[bucketIdx(key)];
+  keyVec_[node] = key;
+  prevVec_[node] = -1;
+  nextVec_[node] = head;
+  if (head != -1) {
+    prevVec_[head] = node;
+  }
+  else {
+    usedBucketIdxVec_.push_back(bucketIdx(key));
+  }
+  head = node;
+}
+
+void BucketQueue::unlink(int node)
+{
+  auto prev = prevVec_[node];
+  auto next = nextVec_[node];
+  if (prev != -1) {
+    nextVec_[prev] = next;
+  }
+  else {
+    headVec_[bucketIdx(keyVec_[node])] = next;
+  }
+  if (next != -1) {
+    prevVec_[next] = prev;
+  }
+}
+
+// Should not be required if maxKeySpread passed to reset() is correct, but
+// keeps the queue correct if a key ends up further ahead than expected.
+void BucketQueue::grow(int maxKeySpread)
+{
+  std::vector<int> nodeVec;
+  for (auto idx : usedBucketIdxVec_) {
+    for (int node = headVec_[idx]; node != -1; node = nextVec_[node]) {
+      nodeVec.push_back(node);
+    }
+    headVec_[idx] = -1;
+  }
+  usedBucketIdxVec_.clear();
+  int nBuckets = nBucketsMask_ + 1;
+  while (nBuckets <= maxKeySpread) {
+    nBuckets <<= 1;
+  }
+  if (nBuckets > static_cast<int>(headVec_.size())) {
+    headVec_.assign(nBuckets, -1);
+  }
+  nBucketsMask_ = nBuckets - 1;
+  for (auto node : nodeVec) {
+    link(node, keyVec_[node]);
+  }
+}
+
+int BucketQueue::bucketIdx(int key)
+{
+  return key & nBucketsMask_;
+}
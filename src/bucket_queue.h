@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+// Priority queue for the Uniform Cost Search, based on Dial's algorithm.
+//
+// The UCS edge costs are small integers (wire, strip and via costs), so the
+// keys that are in the queue at any one time are all within a small window
+// above the lowest key. The queue keeps one bucket per key in that window, in
+// a circular array, and each bucket is a doubly linked list of nodes. This
+// gives O(1) push and decrease-key, and pop is O(1) amortized over the size of
+// the window.
+//
+// Nodes are identified by index, and the links are stored in flat vectors
+// indexed by node, so there is no allocation after reset(). The caller must
+// keep track of which nodes are in the queue.
+//
+// A search usually ends with nodes left in the queue. reset() only clears the
+// buckets that were used since the previous reset(), so it costs as much as
+// the search touched, not the number of buckets.
+
+class BucketQueue
+{
+  public:
+  BucketQueue();
+  void reset(int nNodes, int maxKeySpread);
+  bool isEmpty();
+  void push(int node, int key);
+  void decreaseKey(int node, int key);
+  int pop();
+  int topKey();
+
+  private:
+  void link(int node, int key);
+  void unlink(int node);
+  void grow(int maxKeySpread);
+  int bucketIdx(int key);
+
+  std::vector<int> headVec_;
+  // Buckets that have been non-empty since reset(). May hold duplicates.
+  std::vector<int> usedBucketIdxVec_;
+  std::vector<int> nextVec_;
+  std::vector<int> prevVec_;
+  std::vector<int> keyVec_;
+  int nBucketsMask_;
+  int curKey_;
+  int size_;
+};
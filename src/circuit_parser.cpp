@@ -11,7 +11,7 @@ const auto rxFlags =
     std::regex_constants::ECMAScript | std::regex_constants::icase;
 
 CircuitFileParser::CircuitFileParser(Layout& _layout)
-  : layout_(_layout), offset_(Via(0, 0))
+  : layout_(_layout), input_(_layout.editInput()), offset_(Via(0, 0))
 {
 }
 
@@ -24,7 +24,7 @@ void CircuitFileParser::parse(std::string& circuitFilePath)
   auto fileLockScope = ExclusiveFileLock(circuitFilePath);
   std::ifstream fin(circuitFilePath);
   if (!fin.good()) {
-    layout_.circuit.parserErrorVec.push_back(
+    input_.circuit.parserErrorVec.push_back(
         fmt::format("Cannot read .circuit file: {}", circuitFilePath));
     return;
   }
@@ -39,11 +39,11 @@ void CircuitFileParser::parse(std::string& circuitFilePath)
     try {
       parseLine(lineStr);
     } catch (std::string errorStr) {
-      layout_.circuit.parserErrorVec.push_back(
+      input_.circuit.parserErrorVec.push_back(
           fmt::format("Error on line {:n}: {}: {}", lineIdx, lineStr, errorStr));
     }
   }
-  layout_.isReadyForRouting = !layout_.circuit.hasParserError();
+  layout_.isReadyForRouting = !input_.circuit.hasParserError();
 }
 
 //
@@ -119,8 +119,8 @@ bool CircuitFileParser::parseBoard(std::string& lineStr)
   if (!regex_match(lineStr, m, boardSizeRx)) {
     return false;
   }
-  layout_.gridW = stoi(m[1]);
-  layout_.gridH = stoi(m[2]);
+  input_.gridW = stoi(m[1]);
+  input_.gridH = stoi(m[2]);
   return true;
 }
 
@@ -165,7 +165,7 @@ bool CircuitFileParser::parsePackage(std::string& lineStr)
       return false;
     }
   }
-  layout_.circuit.packageToPosMap[pkgName] = v;
+  input_.circuit.packageToPosMap[pkgName] = v;
   return true;
 }
 
@@ -182,22 +182,22 @@ bool CircuitFileParser::parseComponent(std::string& lineStr)
   auto packageName = m[2].str();
   auto x = std::stoi(m[3]);
   auto y = std::stoi(m[4]);
-  if (layout_.circuit.packageToPosMap.find(packageName)
-      == layout_.circuit.packageToPosMap.end()) {
+  if (input_.circuit.packageToPosMap.find(packageName)
+      == input_.circuit.packageToPosMap.end()) {
     throw fmt::format("Unknown package: {}", packageName);
   }
   Via p = Via(x, y) + offset_;
   auto i = 0;
-  for (auto& v : layout_.circuit.packageToPosMap[packageName]) {
-    if (p.x() + v.x() < 0 || p.x() + v.x() >= layout_.gridW || p.y() + v.y() < 0
-        || p.y() + v.y() >= layout_.gridH) {
+  for (auto& v : input_.circuit.packageToPosMap[packageName]) {
+    if (p.x() + v.x() < 0 || p.x() + v.x() >= input_.gridW || p.y() + v.y() < 0
+        || p.y() + v.y() >= input_.gridH) {
       throw fmt::format(
           "Component pin outside of board: {}.{}", componentName, i + 1);
     }
     ++i;
   }
   Component component(packageName, p);
-  layout_.circuit.componentNameToComponentMap[m[1]] = component;
+  input_.circuit.componentNameToComponentMap[m[1]] = component;
   return true;
 }
 
@@ -213,13 +213,13 @@ bool CircuitFileParser::parseDontCare(std::string& lineStr)
   }
   auto componentName = m[1].str();
   auto componentItr =
-      layout_.circuit.componentNameToComponentMap.find(componentName);
-  if (componentItr == layout_.circuit.componentNameToComponentMap.end()) {
+      input_.circuit.componentNameToComponentMap.find(componentName);
+  if (componentItr == input_.circuit.componentNameToComponentMap.end()) {
     throw fmt::format("Unknown component: {}", componentName);
   }
   auto& component = componentItr->second;
   auto packagePosVec =
-      layout_.circuit.packageToPosMap.find(component.packageName)->second;
+      input_.circuit.packageToPosMap.find(component.packageName)->second;
   for (auto iter = std::sregex_token_iterator(
            lineStr.begin(), lineStr.end(), dontCarePinIdxRx);
        iter != std::sregex_token_iterator(); ++iter) {
@@ -255,21 +255,21 @@ bool CircuitFileParser::parseConnection(std::string& lineStr)
   if (start.componentName == end.componentName && start.pinIdx == end.pinIdx) {
     return true;
   }
-  layout_.circuit.connectionVec.push_back(Connection(start, end));
+  input_.circuit.connectionVec.push_back(Connection(start, end));
   return true;
 }
 
 void CircuitFileParser::checkConnectionPoint(
     const ConnectionPoint& connectionPoint)
 {
-  auto componentItr = layout_.circuit.componentNameToComponentMap.find(
+  auto componentItr = input_.circuit.componentNameToComponentMap.find(
       connectionPoint.componentName);
-  if (componentItr == layout_.circuit.componentNameToComponentMap.end()) {
+  if (componentItr == input_.circuit.componentNameToComponentMap.end()) {
     throw fmt::format("Unknown component: {}", connectionPoint.componentName);
   }
   auto component = componentItr->second;
   auto packagePosVec =
-      layout_.circuit.packageToPosMap.find(component.packageName)->second;
+      input_.circuit.packageToPosMap.find(component.packageName)->second;
   auto pinIdx1Base = connectionPoint.pinIdx + 1;
   if (pinIdx1Base < 1 || pinIdx1Base > static_cast<int>(packagePosVec.size())) {
     throw fmt::format(
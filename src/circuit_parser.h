@@ -27,6 +27,8 @@ class CircuitFileParser
   void checkConnectionPoint(const ConnectionPoint& connectionPoint);
   bool parseAlias(std::string& lineStr);
   Layout& layout_;
+  // The parser fills in the input of a new layout before it is copied.
+  LayoutInput& input_;
   Via offset_;
   std::vector<std::pair<std::string, std::string> > aliases_;
 };
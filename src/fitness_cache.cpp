@@ -0,0 +1,126 @@
+#include <functional>
+
+#include "fitness_cache.h"
+
+//
+// CachedFitness
+//
+
+CachedFitness::CachedFitness() : nCompletedRoutes(0), cost(0)
+{
+}
+
+CachedFitness::CachedFitness(int nCompletedRoutes, long cost)
+  : nCompletedRoutes(nCompletedRoutes), cost(cost)
+{
+}
+
+//
+// FitnessCacheStats
+//
+
+FitnessCacheStats::FitnessCacheStats()
+  : nHits(0), nMisses(0), nEntries(0), memoryBytes(0)
+{
+}
+
+//
+// FitnessCache
+//
+
+FitnessCache::FitnessCache(size_t maxBytes) : maxBytes_(maxBytes)
+{
+}
+
+// Takes effect at the next insert.
+void FitnessCache::setMaxBytes(size_t maxBytes)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  maxBytes_ = maxBytes;
+}
+
+bool FitnessCache::find(
+    Layout& layout, const ConnectionIdxVec& connectionIdxVec,
+    CachedFitness& fitness)
+{
+  auto hash = hashOrdering(connectionIdxVec);
+  std::lock_guard<std::mutex> lock(mutex_);
+  clearIfOtherLayout(layout);
+  auto itr = entryMap_.find(hash);
+  if (itr == entryMap_.end()
+      || itr->second->connectionIdxVec != connectionIdxVec) {
+    ++stats_.nMisses;
+    return false;
+  }
+  entryList_.splice(entryList_.begin(), entryList_, itr->second);
+  fitness = itr->second->fitness;
+  ++stats_.nHits;
+  return true;
+}
+
+void FitnessCache::insert(
+    Layout& layout, const ConnectionIdxVec& connectionIdxVec,
+    const CachedFitness& fitness)
+{
+  Entry entry;
+  entry.hash = hashOrdering(connectionIdxVec);
+  entry.connectionIdxVec = connectionIdxVec;
+  entry.fitness = fitness;
+  // Approximate, as the allocator overhead of the containers is not known.
+  entry.memoryBytes =
+      sizeof(Entry) + 4 * sizeof(void*)
+      + entry.connectionIdxVec.capacity() * sizeof(ConnectionIdx);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  clearIfOtherLayout(layout);
+  // Another thread may have inserted the same ordering, or a different
+  // ordering with the same hash. Either way, the new entry replaces the old.
+  auto itr = entryMap_.find(entry.hash);
+  if (itr != entryMap_.end()) {
+    stats_.memoryBytes -= itr->second->memoryBytes;
+    entryList_.erase(itr->second);
+    entryMap_.erase(itr);
+  }
+  stats_.memoryBytes += entry.memoryBytes;
+  entryList_.push_front(std::move(entry));
+  entryMap_[entryList_.front().hash] = entryList_.begin();
+  while (stats_.memoryBytes > maxBytes_ && entryList_.size()) {
+    auto& lru = entryList_.back();
+    stats_.memoryBytes -= lru.memoryBytes;
+    entryMap_.erase(lru.hash);
+    entryList_.pop_back();
+  }
+  stats_.nEntries = static_cast<long>(entryList_.size());
+}
+
+FitnessCacheStats FitnessCache::getStats()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+//
+// Private
+//
+
+void FitnessCache::clearIfOtherLayout(Layout& layout)
+{
+  if (layout.getBaseTimestamp() == baseTimestamp_) {
+    return;
+  }
+  baseTimestamp_ = layout.getBaseTimestamp();
+  entryList_.clear();
+  entryMap_.clear();
+  stats_ = FitnessCacheStats();
+}
+
+size_t FitnessCache::hashOrdering(const ConnectionIdxVec& connectionIdxVec)
+{
+  size_t hash = 0;
+  for (auto connectionIdx : connectionIdxVec) {
+    // boost::hash_combine
+    hash ^= std::hash<ConnectionIdx>()(connectionIdx) + 0x9e3779b9
+            + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
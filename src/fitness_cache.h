@@ -0,0 +1,73 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "ga_interface.h"
+#include "layout.h"
+
+// Late in a run, most organisms in the population decode to orderings that
+// have already been routed. Routing is deterministic, so this cache holds the
+// fitness for each routed ordering, and orderings that are found in the cache
+// are not routed again.
+//
+// The cache holds up to maxBytes of entries and evicts the least recently
+// used. It is shared by all router threads. Like RouteCache, it is only valid
+// for a single input layout, and is cleared when it is used with a layout that
+// has a different base timestamp.
+
+class CachedFitness
+{
+  public:
+  CachedFitness();
+  CachedFitness(int nCompletedRoutes, long cost);
+  int nCompletedRoutes;
+  long cost;
+};
+
+class FitnessCacheStats
+{
+  public:
+  FitnessCacheStats();
+  long nHits;
+  long nMisses;
+  long nEntries;
+  size_t memoryBytes;
+};
+
+class FitnessCache
+{
+  public:
+  FitnessCache(size_t maxBytes);
+  void setMaxBytes(size_t maxBytes);
+  bool find(
+      Layout& layout, const ConnectionIdxVec& connectionIdxVec,
+      CachedFitness& fitness);
+  void insert(
+      Layout& layout, const ConnectionIdxVec& connectionIdxVec,
+      const CachedFitness& fitness);
+  FitnessCacheStats getStats();
+
+  private:
+  class Entry
+  {
+    public:
+    size_t hash;
+    ConnectionIdxVec connectionIdxVec;
+    CachedFitness fitness;
+    size_t memoryBytes;
+  };
+  typedef std::list<Entry> EntryList;
+
+  void clearIfOtherLayout(Layout& layout);
+  size_t hashOrdering(const ConnectionIdxVec& connectionIdxVec);
+
+  size_t maxBytes_;
+  std::mutex mutex_;
+  Timestamp baseTimestamp_;
+  // Most recently used first
+  EntryList entryList_;
+  std::unordered_map<size_t, EntryList::iterator> entryMap_;
+  FitnessCacheStats stats_;
+};
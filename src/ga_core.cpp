@@ -1,15 +1,13 @@
 #include <algorithm>
 #include <cassert>
-#include <chrono>
 #include <climits>
 #include <forward_list>
-#include <list>
-#include <random>
-#include <unordered_set>
+#include <queue>
 
 #include <fmt/format.h>
 
 #include "ga_core.h"
+#include "ga_permutation.h"
 
 GeneDependency::GeneDependency(Gene gene, Gene geneDependency)
   : gene(gene), geneDependency(geneDependency)
@@ -17,66 +15,101 @@ GeneDependency::GeneDependency(Gene gene, Gene geneDependency)
 }
 
 //
-// Random
+// Encoding
 //
 
-RandomIntGenerator::RandomIntGenerator()
-  : randomEngine_(static_cast<unsigned long>(
-        std::chrono::system_clock::now().time_since_epoch().count()))
+GeneEncoding::GeneEncoding()
+  : type(EncodingType::Dependency),
+    crossover(PermutationCrossover::Order),
+    mutation(PermutationMutation::Swap)
 {
 }
 
-RandomIntGenerator::RandomIntGenerator(int min, int max)
-  : randomEngine_(static_cast<unsigned long>(
-        std::chrono::system_clock::now().time_since_epoch().count()))
-{
-  setRange(min, max);
-}
-
-void RandomIntGenerator::setRange(int min, int max)
-{
-  uniformIntDistribution_ = std::uniform_int_distribution<>(min, max);
-}
-
-GeneIdx RandomIntGenerator::getRandomInt()
-{
-  return uniformIntDistribution_(randomEngine_);
-}
-
 //
 // Organism
 //
 
-Organism::Organism(int nGenes, RandomIntGenerator& randomGeneSelector)
+Organism::Organism(int nGenes, const GeneEncoding& encoding)
   : nCompletedRoutes(0),
     completedRouteCost(0),
+    isEvaluated(false),
     nGenes_(nGenes),
-    randomGeneSelector_(randomGeneSelector)
+    encoding_(encoding)
 {
 }
 
-void Organism::createRandom()
+void Organism::createRandom(RandomEngine& randomEngine)
 {
+  if (encoding_.type == EncodingType::Permutation) {
+    geneVec = createRandomPermutation(nGenes_, randomEngine);
+    return;
+  }
   for (int i = 0; i < nGenes_; ++i) {
-    geneVec.push_back(randomGeneSelector_.getRandomInt());
+    geneVec.push_back(getRandomGeneIdx(randomEngine));
   }
 }
 
-GeneIdx Organism::getRandomCrossoverPoint()
+GeneIdx Organism::getRandomCrossoverPoint(RandomEngine& randomEngine)
 {
-  return randomGeneSelector_.getRandomInt();
+  return getRandomGeneIdx(randomEngine);
 }
 
-void Organism::mutate()
+void Organism::mutate(RandomEngine& randomEngine)
 {
-  auto dependentIdx = randomGeneSelector_.getRandomInt();
-  auto dependencyIdx = randomGeneSelector_.getRandomInt();
+  if (encoding_.type == EncodingType::Permutation) {
+    switch (encoding_.mutation) {
+    case PermutationMutation::Swap:
+      swapMutation(geneVec, randomEngine);
+      break;
+    case PermutationMutation::Insert:
+      insertMutation(geneVec, randomEngine);
+      break;
+    case PermutationMutation::Inversion:
+      inversionMutation(geneVec, randomEngine);
+      break;
+    }
+    return;
+  }
+  auto dependentIdx = getRandomGeneIdx(randomEngine);
+  auto dependencyIdx = getRandomGeneIdx(randomEngine);
   geneVec[dependentIdx] = dependencyIdx;
 }
 
+// Carry the genes over to a new set of genes, where newToPrevGeneVec holds the
+// previous gene for each new gene, or -1 for genes that have been added, and
+// prevToNewGeneVec is the reverse. Dependencies on genes that have been
+// removed, and the dependencies of genes that have been added, are
+// randomized.
+void Organism::remap(
+    const GeneVec& newToPrevGeneVec, const GeneVec& prevToNewGeneVec,
+    RandomEngine& randomEngine)
+{
+  nGenes_ = static_cast<int>(newToPrevGeneVec.size());
+  nCompletedRoutes = 0;
+  completedRouteCost = 0;
+  isEvaluated = false;
+  if (encoding_.type == EncodingType::Permutation) {
+    geneVec = remapPermutation(
+        geneVec, newToPrevGeneVec, prevToNewGeneVec, randomEngine);
+    return;
+  }
+  GeneVec newGeneVec;
+  for (auto prevGene : newToPrevGeneVec) {
+    auto dependency = prevGene == -1 ? -1 : prevToNewGeneVec[geneVec[prevGene]];
+    if (dependency == -1) {
+      dependency = getRandomGeneIdx(randomEngine);
+    }
+    newGeneVec.push_back(dependency);
+  }
+  geneVec.swap(newGeneVec);
+}
+
 GeneVec Organism::calcConnectionIdxVec()
 {
-  auto geneVec = topoSort();
+  if (encoding_.type == EncodingType::Permutation) {
+    return geneVec;
+  }
+  auto geneVec = topoSort(this->geneVec);
   assert(static_cast<int>(geneVec.size()) == nGenes_);
   return geneVec;
 }
@@ -96,44 +129,94 @@ void Organism::dump()
 // Private
 //
 
-GeneVec Organism::topoSort()
+GeneIdx Organism::getRandomGeneIdx(RandomEngine& randomEngine)
 {
-  std::list<GeneDependency> geneList;
-  int i = 0;
-  //  fmt::print("{}\n", geneVec.size());
-  for (auto geneIdx : geneVec) {
-    geneList.push_back(GeneDependency(i, geneIdx));
-    ++i;
-  }
+  return randomEngine.getRandomInt(0, nGenes_ - 1);
+}
 
-  geneList.sort([](const GeneDependency& a, const GeneDependency& b) -> bool {
-    return a.geneDependency < b.geneDependency;
-  });
+//
+// Topological sort
+//
 
-  GeneVec geneVec;
-  std::unordered_set<int> dependencySet;
+// Decode a genome into an ordering. Gene i holds the index of the gene that
+// it depends on, and each gene is placed after its dependency where possible.
+//
+// The genes are kept in a list sorted by dependency, which is swept from the
+// front to the back repeatedly. During a sweep, each gene whose dependency has
+// already been placed is placed, and if a sweep places no genes, the gene at
+// the front of the list is placed. Instead of sweeping over the list, this
+// keeps the list positions of the genes that can be placed in two heaps, one
+// for positions that are still ahead in the current sweep and one for the next
+// sweep. Each gene enters a heap at most once, so this is O(n log n) instead
+// of the O(n^2) of the sweeps, and gives the same ordering.
+GeneVec topoSort(const GeneVec& geneVec)
+{
+  typedef std::priority_queue<int, std::vector<int>, std::greater<int>>
+      PositionHeap;
+  int nGenes = static_cast<int>(geneVec.size());
+  // Stable counting sort of the genes by dependency. The genes that depend on
+  // gene g are at positions firstPosVec[g] to firstPosVec[g + 1] - 1.
+  std::vector<int> firstPosVec(nGenes + 1, 0);
+  for (auto dependency : geneVec) {
+    ++firstPosVec[dependency + 1];
+  }
+  for (int i = 0; i < nGenes; ++i) {
+    firstPosVec[i + 1] += firstPosVec[i];
+  }
+  GeneVec sortedGeneVec(nGenes);
+  {
+    auto nextPosVec = firstPosVec;
+    for (Gene gene = 0; gene < nGenes; ++gene) {
+      sortedGeneVec[nextPosVec[geneVec[gene]]++] = gene;
+    }
+  }
 
-  while (geneList.size()) {
-    bool found = false;
-    auto itr = geneList.begin();
-    while (itr != geneList.end()) {
-      if (dependencySet.count(itr->geneDependency)) {
-        geneVec.push_back(itr->gene);
-        dependencySet.insert(itr->gene);
-        itr = geneList.erase(itr);
-        found = true;
+  GeneVec orderingVec;
+  orderingVec.reserve(nGenes);
+  std::vector<bool> isPlacedVec(nGenes, false);
+  PositionHeap sweepHeap;
+  PositionHeap nextSweepHeap;
+  int sweepPos = -1;
+  int frontPos = 0;
+  bool isPlacedInSweep = false;
+
+  auto place = [&](Gene gene) {
+    orderingVec.push_back(gene);
+    isPlacedVec[gene] = true;
+    for (int pos = firstPosVec[gene]; pos < firstPosVec[gene + 1]; ++pos) {
+      if (isPlacedVec[sortedGeneVec[pos]]) {
+        continue;
+      }
+      if (pos > sweepPos) {
+        sweepHeap.push(pos);
       }
       else {
-        ++itr;
+        nextSweepHeap.push(pos);
       }
     }
-    if (!found) {
-      geneVec.push_back(geneList.front().gene);
-      dependencySet.insert(geneList.front().gene);
-      geneList.pop_front();
+  };
+
+  while (static_cast<int>(orderingVec.size()) < nGenes) {
+    if (sweepHeap.size()) {
+      sweepPos = sweepHeap.top();
+      sweepHeap.pop();
+      place(sortedGeneVec[sweepPos]);
+      isPlacedInSweep = true;
+      continue;
     }
+    // End of sweep. If the sweep placed no genes, the next sweep starts
+    // after placing the gene at the front of the list.
+    sweepPos = -1;
+    sweepHeap.swap(nextSweepHeap);
+    if (!isPlacedInSweep) {
+      while (isPlacedVec[sortedGeneVec[frontPos]]) {
+        ++frontPos;
+      }
+      place(sortedGeneVec[frontPos]);
+    }
+    isPlacedInSweep = false;
   }
-  return geneVec;
+  return orderingVec;
 }
 
 //
@@ -145,11 +228,14 @@ OrganismPair::OrganismPair(Organism& a, Organism& b) : a(a), b(b)
 }
 
 Population::Population(
-    int nOrganismsInPopulation, double crossoverRate, double mutationRate)
+    int nOrganismsInPopulation, double crossoverRate, double mutationRate,
+    int randomStreamIdx, const GeneEncoding& encoding)
   : nOrganismsInPopulation_(nOrganismsInPopulation),
     crossoverRate_(crossoverRate),
     mutationRate_(mutationRate),
-    randomOrganismSelector_(0, nOrganismsInPopulation - 1)
+    randomStreamIdx_(randomStreamIdx),
+    encoding_(encoding),
+    randomEngine_(getRandomSeed(), randomStreamIdx)
 {
   assert(!(nOrganismsInPopulation & 1)); // Must have even number of organisms
 }
@@ -157,8 +243,44 @@ Population::Population(
 void Population::reset(int nGenesPerOrganism)
 {
   nGenesPerOrganism_ = nGenesPerOrganism;
-  randomGeneSelector_.setRange(0, nGenesPerOrganism - 1);
+  // Restart the stream, so that each input layout gets the same sequence for
+  // a given seed.
+  randomEngine_ = RandomEngine(getRandomSeed(), randomStreamIdx_);
   createRandomPopulation();
+  nEvaluatedOrganisms_ = 0;
+  offspringVec.clear();
+  freeOffspringIdxVec_.clear();
+}
+
+// Keep the evolved organisms when the genes change only partially, e.g.,
+// because a component was moved or a connection was added. All organisms need
+// to be evaluated again, and they are sorted so that the organisms that were
+// fittest are evaluated first.
+void Population::warmStart(const GeneVec& newToPrevGeneVec)
+{
+  GeneVec prevToNewGeneVec(nGenesPerOrganism_, -1);
+  for (Gene gene = 0; gene < static_cast<int>(newToPrevGeneVec.size());
+       ++gene) {
+    if (newToPrevGeneVec[gene] != -1) {
+      prevToNewGeneVec[newToPrevGeneVec[gene]] = gene;
+    }
+  }
+  nGenesPerOrganism_ = static_cast<int>(newToPrevGeneVec.size());
+  randomEngine_ = RandomEngine(getRandomSeed(), randomStreamIdx_);
+  std::stable_sort(
+      organismVec.begin(), organismVec.end(),
+      [&](const Organism& a, const Organism& b) {
+        if (a.isEvaluated != b.isEvaluated) {
+          return a.isEvaluated;
+        }
+        return isFitter(a, b);
+      });
+  for (auto& organism : organismVec) {
+    organism.remap(newToPrevGeneVec, prevToNewGeneVec, randomEngine_);
+  }
+  nEvaluatedOrganisms_ = 0;
+  offspringVec.clear();
+  freeOffspringIdxVec_.clear();
 }
 
 void Population::nextGeneration()
@@ -167,15 +289,15 @@ void Population::nextGeneration()
   auto nMutations = 0;
   for (int i = 0; i < nOrganismsInPopulation_ / 2; ++i) {
     auto pair = selectPairTournament(2);
-    if (getNormalizedRandom() < crossoverRate_) {
+    if (randomEngine_.getNormalizedRandom() < crossoverRate_) {
       crossover(pair);
     }
-    if (getNormalizedRandom() < mutationRate_) {
-      pair.a.mutate();
+    if (randomEngine_.getNormalizedRandom() < mutationRate_) {
+      pair.a.mutate(randomEngine_);
       ++nMutations;
     }
-    if (getNormalizedRandom() < mutationRate_) {
-      pair.b.mutate();
+    if (randomEngine_.getNormalizedRandom() < mutationRate_) {
+      pair.b.mutate(randomEngine_);
       ++nMutations;
     }
     newGenerationVec.push_back(pair.a);
@@ -185,6 +307,175 @@ void Population::nextGeneration()
   organismVec.swap(newGenerationVec);
 }
 
+void Population::setFitness(
+    Organism& organism, int nCompletedRoutes, long completedRouteCost)
+{
+  if (!organism.isEvaluated) {
+    organism.isEvaluated = true;
+    ++nEvaluatedOrganisms_;
+  }
+  organism.nCompletedRoutes = nCompletedRoutes;
+  organism.completedRouteCost = completedRouteCost;
+}
+
+//
+// Steady-state
+//
+// Instead of replacing the whole population at once, each offspring is created
+// on demand from parents that have already been evaluated, and replaces a
+// weak organism in the population as soon as it has been evaluated itself. So
+// there is no generation boundary where the caller has to wait for the
+// slowest organism to be evaluated. Offspring that are being evaluated are
+// held in offspringVec.
+
+// Tournament selection requires two evaluated organisms.
+bool Population::canCreateOffspring()
+{
+  return nEvaluatedOrganisms_ >= 2;
+}
+
+OrganismIdx Population::createOffspring()
+{
+  assert(canCreateOffspring());
+  // Crossover and mutation work on copies, so the parents stay in the
+  // population unchanged.
+  auto parents = selectPairTournament(2);
+  Organism a = parents.a;
+  Organism b = parents.b;
+  OrganismPair pair(a, b);
+  if (randomEngine_.getNormalizedRandom() < crossoverRate_) {
+    crossover(pair);
+  }
+  if (randomEngine_.getNormalizedRandom() < mutationRate_) {
+    a.mutate(randomEngine_);
+  }
+  OrganismIdx offspringIdx;
+  if (freeOffspringIdxVec_.size()) {
+    offspringIdx = freeOffspringIdxVec_.back();
+    freeOffspringIdxVec_.pop_back();
+  }
+  else {
+    offspringIdx = static_cast<OrganismIdx>(offspringVec.size());
+    offspringVec.push_back(a);
+  }
+  auto& offspring = offspringVec[offspringIdx];
+  offspring.geneVec = a.geneVec;
+  offspring.isEvaluated = false;
+  return offspringIdx;
+}
+
+// Offspring are not in the population, so unlike setFitness(), this does not
+// count them as evaluated organisms.
+void Population::setOffspringFitness(
+    OrganismIdx offspringIdx, int nCompletedRoutes, long completedRouteCost)
+{
+  auto& offspring = offspringVec[offspringIdx];
+  offspring.isEvaluated = true;
+  offspring.nCompletedRoutes = nCompletedRoutes;
+  offspring.completedRouteCost = completedRouteCost;
+}
+
+// Replace the least fit of a few random organisms with the evaluated
+// offspring.
+void Population::insertOffspring(OrganismIdx offspringIdx)
+{
+  auto& offspring = offspringVec[offspringIdx];
+  assert(offspring.isEvaluated);
+  auto& organism = organismVec[reverseTournamentSelect(2)];
+  organism.geneVec = offspring.geneVec;
+  organism.nCompletedRoutes = offspring.nCompletedRoutes;
+  organism.completedRouteCost = offspring.completedRouteCost;
+  freeOffspringIdxVec_.push_back(offspringIdx);
+}
+
+//
+// Island model
+//
+
+// Return copies of the fittest evaluated organisms.
+OrganismVec Population::getFittest(int nOrganisms)
+{
+  auto organismIdxVec = getEvaluatedByFitness();
+  OrganismVec fittestVec;
+  for (auto itr = organismIdxVec.rbegin();
+       itr != organismIdxVec.rend()
+       && static_cast<int>(fittestVec.size()) < nOrganisms;
+       ++itr) {
+    fittestVec.push_back(organismVec[*itr]);
+  }
+  return fittestVec;
+}
+
+// Replace the least fit evaluated organisms with the migrants. Organisms that
+// have not been evaluated may be in use by a router thread, so they are not
+// replaced.
+void Population::immigrate(const OrganismVec& migrantVec)
+{
+  auto organismIdxVec = getEvaluatedByFitness();
+  for (int i = 0; i < static_cast<int>(migrantVec.size())
+                  && i < static_cast<int>(organismIdxVec.size());
+       ++i) {
+    auto& migrant = migrantVec[i];
+    if (static_cast<int>(migrant.geneVec.size()) != nGenesPerOrganism_) {
+      continue;
+    }
+    auto& organism = organismVec[organismIdxVec[i]];
+    organism.geneVec = migrant.geneVec;
+    organism.nCompletedRoutes = migrant.nCompletedRoutes;
+    organism.completedRouteCost = migrant.completedRouteCost;
+  }
+}
+
+//
+// Checkpoint
+//
+
+PopulationSnapshot Population::getSnapshot()
+{
+  PopulationSnapshot snapshot;
+  snapshot.organismVec = organismVec;
+  snapshot.randomEngineState = randomEngine_.getState();
+  return snapshot;
+}
+
+// Replace the population with the organisms of a snapshot taken for the same
+// genes. The fittest organisms are kept if the snapshot has more organisms
+// than the population, and random organisms are added if it has fewer. Return
+// false if the snapshot does not match the genes.
+bool Population::restore(const PopulationSnapshot& snapshot)
+{
+  for (auto& organism : snapshot.organismVec) {
+    if (static_cast<int>(organism.geneVec.size()) != nGenesPerOrganism_) {
+      return false;
+    }
+  }
+  auto snapshotVec = snapshot.organismVec;
+  std::stable_sort(
+      snapshotVec.begin(), snapshotVec.end(),
+      [&](const Organism& a, const Organism& b) {
+        if (a.isEvaluated != b.isEvaluated) {
+          return a.isEvaluated;
+        }
+        return isFitter(a, b);
+      });
+  createRandomPopulation();
+  nEvaluatedOrganisms_ = 0;
+  for (int i = 0; i < static_cast<int>(snapshotVec.size())
+                  && i < nOrganismsInPopulation_;
+       ++i) {
+    auto& organism = organismVec[i];
+    organism.geneVec = snapshotVec[i].geneVec;
+    organism.nCompletedRoutes = snapshotVec[i].nCompletedRoutes;
+    organism.completedRouteCost = snapshotVec[i].completedRouteCost;
+    organism.isEvaluated = snapshotVec[i].isEvaluated;
+    nEvaluatedOrganisms_ += organism.isEvaluated;
+  }
+  offspringVec.clear();
+  freeOffspringIdxVec_.clear();
+  randomEngine_.setState(snapshot.randomEngineState);
+  return true;
+}
+
 //
 // Private
 //
@@ -193,20 +484,51 @@ void Population::createRandomPopulation()
 {
   organismVec.clear();
   for (int i = 0; i < nOrganismsInPopulation_; ++i) {
-    Organism organism(nGenesPerOrganism_, randomGeneSelector_);
-    organism.createRandom();
+    Organism organism(nGenesPerOrganism_, encoding_);
+    organism.createRandom(randomEngine_);
     organismVec.push_back(organism);
   }
 }
 
 void Population::crossover(OrganismPair& pair)
 {
-  auto crossIdx = pair.a.getRandomCrossoverPoint();
+  if (encoding_.type == EncodingType::Permutation) {
+    permutationCrossover(pair);
+    return;
+  }
+  auto crossIdx = pair.a.getRandomCrossoverPoint(randomEngine_);
   for (int i = crossIdx; i < static_cast<int>(pair.a.geneVec.size()); ++i) {
     std::swap(pair.a.geneVec[i], pair.b.geneVec[i]);
   }
 }
 
+// Each child gets its segment or start from a different parent.
+void Population::permutationCrossover(OrganismPair& pair)
+{
+  GeneVec childAVec;
+  GeneVec childBVec;
+  switch (encoding_.crossover) {
+  case PermutationCrossover::Order:
+    childAVec = orderCrossover(pair.a.geneVec, pair.b.geneVec, randomEngine_);
+    childBVec = orderCrossover(pair.b.geneVec, pair.a.geneVec, randomEngine_);
+    break;
+  case PermutationCrossover::PartiallyMapped:
+    childAVec = partiallyMappedCrossover(
+        pair.a.geneVec, pair.b.geneVec, randomEngine_);
+    childBVec = partiallyMappedCrossover(
+        pair.b.geneVec, pair.a.geneVec, randomEngine_);
+    break;
+  case PermutationCrossover::EdgeRecombination:
+    childAVec = edgeRecombinationCrossover(
+        pair.a.geneVec, pair.b.geneVec, randomEngine_);
+    childBVec = edgeRecombinationCrossover(
+        pair.b.geneVec, pair.a.geneVec, randomEngine_);
+    break;
+  }
+  pair.a.geneVec.swap(childAVec);
+  pair.b.geneVec.swap(childBVec);
+}
+
 OrganismPair Population::selectPairTournament(int nCandidates)
 {
   auto organismAIdx = tournamentSelect(nCandidates);
@@ -225,7 +547,7 @@ OrganismIdx Population::tournamentSelect(int nCandidates)
   int nHighestCompletedRoutes = 0;
 
   for (int i = 0; i < nCandidates; ++i) {
-    OrganismIdx organismIdx = randomOrganismSelector_.getRandomInt();
+    OrganismIdx organismIdx = selectEvaluatedOrganism();
 
     auto& organism = organismVec[organismIdx];
 
@@ -256,9 +578,52 @@ OrganismIdx Population::tournamentSelect(int nCandidates)
   return bestOrganismIdx;
 }
 
-double Population::getNormalizedRandom()
+OrganismIdx Population::reverseTournamentSelect(int nCandidates)
+{
+  OrganismIdx worstOrganismIdx = selectEvaluatedOrganism();
+  for (int i = 1; i < nCandidates; ++i) {
+    OrganismIdx organismIdx = selectEvaluatedOrganism();
+    if (isFitter(organismVec[worstOrganismIdx], organismVec[organismIdx])) {
+      worstOrganismIdx = organismIdx;
+    }
+  }
+  return worstOrganismIdx;
+}
+
+// In the generational GA, all organisms have been evaluated when a new
+// generation is created. In the steady-state GA, organisms from the initial
+// population may still be waiting to be evaluated.
+OrganismIdx Population::selectEvaluatedOrganism()
+{
+  while (true) {
+    OrganismIdx organismIdx =
+        randomEngine_.getRandomInt(0, nOrganismsInPopulation_ - 1);
+    if (organismVec[organismIdx].isEvaluated) {
+      return organismIdx;
+    }
+  }
+}
+
+// Least fit first
+std::vector<OrganismIdx> Population::getEvaluatedByFitness()
+{
+  std::vector<OrganismIdx> organismIdxVec;
+  for (OrganismIdx i = 0; i < nOrganismsInPopulation_; ++i) {
+    if (organismVec[i].isEvaluated) {
+      organismIdxVec.push_back(i);
+    }
+  }
+  std::sort(
+      organismIdxVec.begin(), organismIdxVec.end(),
+      [&](OrganismIdx a, OrganismIdx b) {
+        return isFitter(organismVec[b], organismVec[a]);
+      });
+  return organismIdxVec;
+}
+
+bool Population::isFitter(const Organism& a, const Organism& b)
 {
-  static std::default_random_engine e;
-  static std::uniform_real_distribution<> d(0.0, 1.0);
-  return d(e);
+  return a.nCompletedRoutes > b.nCompletedRoutes
+         || (a.nCompletedRoutes == b.nCompletedRoutes
+             && a.completedRouteCost < b.completedRouteCost);
 }
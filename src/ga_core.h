@@ -1,43 +1,69 @@
 #pragma once
 
 #include <mutex>
-#include <random>
 #include <thread>
 #include <vector>
 
+#include "random_engine.h"
+
 //
-// Random
+// Gene
 //
 
 typedef int GeneIdx;
 
-class RandomIntGenerator
+typedef int Gene;
+typedef std::vector<Gene> GeneVec;
+
+class GeneDependency
 {
   public:
-  RandomIntGenerator();
-  RandomIntGenerator(int min, int max);
-  void setRange(int min, int max);
-  int getRandomInt();
+  GeneDependency(Gene gene, Gene geneDependency);
 
-  private:
-  std::default_random_engine randomEngine_;
-  std::uniform_int_distribution<> uniformIntDistribution_;
+  Gene gene;
+  Gene geneDependency;
 };
 
+GeneVec topoSort(const GeneVec& geneVec);
+
 //
-// Gene
+// Encoding
 //
 
-typedef int Gene;
-typedef std::vector<Gene> GeneVec;
+// Dependency: Gene i holds the index of the connection that connection i
+// should be routed after, and the genes are decoded into an ordering by
+// topoSort(). Crossover swaps the genes after a random point and mutation sets
+// a random dependency.
+//
+// Permutation: The genes are the ordering itself, so there is no decode step.
+// The crossover and mutation operators are selectable.
+enum class EncodingType
+{
+  Dependency,
+  Permutation
+};
 
-class GeneDependency
+enum class PermutationCrossover
 {
-  public:
-  GeneDependency(Gene gene, Gene geneDependency);
+  Order,
+  PartiallyMapped,
+  EdgeRecombination
+};
 
-  Gene gene;
-  Gene geneDependency;
+enum class PermutationMutation
+{
+  Swap,
+  Insert,
+  Inversion
+};
+
+class GeneEncoding
+{
+  public:
+  GeneEncoding();
+  EncodingType type;
+  PermutationCrossover crossover;
+  PermutationMutation mutation;
 };
 
 //
@@ -47,23 +73,27 @@ class GeneDependency
 class Organism
 {
   public:
-  Organism(int nGenes, RandomIntGenerator& randomGeneSelector);
-  void createRandom();
-  GeneIdx getRandomCrossoverPoint();
-  void mutate();
+  Organism(int nGenes, const GeneEncoding& encoding);
+  void createRandom(RandomEngine& randomEngine);
+  GeneIdx getRandomCrossoverPoint(RandomEngine& randomEngine);
+  void mutate(RandomEngine& randomEngine);
+  void remap(
+      const GeneVec& newToPrevGeneVec, const GeneVec& prevToNewGeneVec,
+      RandomEngine& randomEngine);
   GeneVec calcConnectionIdxVec();
   void dump();
 
   int nCompletedRoutes;
   long completedRouteCost;
+  bool isEvaluated;
 
   GeneVec geneVec;
 
   private:
-  GeneVec topoSort();
+  GeneIdx getRandomGeneIdx(RandomEngine& randomEngine);
 
   int nGenes_;
-  RandomIntGenerator& randomGeneSelector_;
+  GeneEncoding encoding_;
 };
 
 //
@@ -82,27 +112,59 @@ typedef int OrganismIdx;
 
 typedef std::vector<Organism> OrganismVec;
 
+// The organisms and random state of a Population, for checkpoints
+class PopulationSnapshot
+{
+  public:
+  OrganismVec organismVec;
+  RandomEngineState randomEngineState;
+};
+
 class Population
 {
   public:
   Population(
-      int nOrganismsInPopulation, double crossoverRate, double mutationRate);
+      int nOrganismsInPopulation, double crossoverRate, double mutationRate,
+      int randomStreamIdx, const GeneEncoding& encoding);
   void reset(int nGenesPerOrganism);
+  void warmStart(const GeneVec& newToPrevGeneVec);
   void nextGeneration();
+  void setFitness(
+      Organism& organism, int nCompletedRoutes, long completedRouteCost);
+  // Steady-state
+  bool canCreateOffspring();
+  OrganismIdx createOffspring();
+  void setOffspringFitness(
+      OrganismIdx offspringIdx, int nCompletedRoutes, long completedRouteCost);
+  void insertOffspring(OrganismIdx offspringIdx);
+  // Island model
+  OrganismVec getFittest(int nOrganisms);
+  void immigrate(const OrganismVec& migrantVec);
+  // Checkpoint
+  PopulationSnapshot getSnapshot();
+  bool restore(const PopulationSnapshot& snapshot);
 
   OrganismVec organismVec;
+  OrganismVec offspringVec;
 
   private:
   void createRandomPopulation();
   void crossover(OrganismPair& pair);
+  void permutationCrossover(OrganismPair& pair);
   OrganismPair selectPairTournament(int nCandidates);
   OrganismIdx tournamentSelect(int nCandidates);
-  double getNormalizedRandom();
+  OrganismIdx reverseTournamentSelect(int nCandidates);
+  OrganismIdx selectEvaluatedOrganism();
+  std::vector<OrganismIdx> getEvaluatedByFitness();
+  bool isFitter(const Organism& a, const Organism& b);
 
   int nOrganismsInPopulation_;
   double crossoverRate_;
   double mutationRate_;
   int nGenesPerOrganism_;
-  RandomIntGenerator randomGeneSelector_;
-  RandomIntGenerator randomOrganismSelector_;
+  int nEvaluatedOrganisms_;
+  std::vector<OrganismIdx> freeOffspringIdxVec_;
+  int randomStreamIdx_;
+  GeneEncoding encoding_;
+  RandomEngine randomEngine_;
 };
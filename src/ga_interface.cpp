@@ -1,4 +1,4 @@
-//#include <algorithm>
+#include <algorithm>
 #include <cassert>
 //#include <chrono>
 //#include <forward_list>
@@ -8,21 +8,48 @@
 #include "ga_interface.h"
 
 GeneticAlgorithm::GeneticAlgorithm(
-    int nOrganismsInPopulation, double crossoverRate, double mutationRate)
+    int nOrganismsInPopulation, double crossoverRate, double mutationRate,
+    int randomStreamIdx, const GeneEncoding& encoding)
   : nOrganismsInPopulation_(nOrganismsInPopulation),
+    encoding_(encoding),
     crossoverRate_(crossoverRate),
     mutationRate_(mutationRate),
     nConnectionsInCircuit_(0),
-    population_(nOrganismsInPopulation, crossoverRate, mutationRate)
+    isSteadyState_(false),
+    nResets_(0),
+    nGenerations_(0),
+    nOffspringInGeneration_(0),
+    inbox_(nullptr),
+    outbox_(nullptr),
+    migrationInterval_(0),
+    nMigrants_(0),
+    migrationEpoch_(0),
+    population_(
+        nOrganismsInPopulation, crossoverRate, mutationRate, randomStreamIdx,
+        encoding)
 {
 }
 
-void GeneticAlgorithm::reset(int nConnectionsInCircuit)
+void GeneticAlgorithm::reset(int nConnectionsInCircuit, bool isSteadyState)
 {
   nConnectionsInCircuit_ = nConnectionsInCircuit;
+  isSteadyState_ = isSteadyState;
   population_.reset(nConnectionsInCircuit);
-  nextOrderingIdx_ = 0;
-  nUnprocessedOrderings_ = nOrganismsInPopulation_;
+  restart();
+}
+
+void GeneticAlgorithm::warmStart(
+    const ConnectionIdxVec& prevConnectionIdxVec, bool isSteadyState)
+{
+  auto nConnectionsInCircuit = static_cast<int>(prevConnectionIdxVec.size());
+  if (!nConnectionsInCircuit_ || !nConnectionsInCircuit) {
+    reset(nConnectionsInCircuit, isSteadyState);
+    return;
+  }
+  nConnectionsInCircuit_ = nConnectionsInCircuit;
+  isSteadyState_ = isSteadyState;
+  population_.warmStart(prevConnectionIdxVec);
+  restart();
 }
 
 OrderingIdx GeneticAlgorithm::reserveOrdering()
@@ -30,10 +57,17 @@ OrderingIdx GeneticAlgorithm::reserveOrdering()
   if (!nConnectionsInCircuit_) {
     return -1;
   }
+  if (isSteadyState_ && nextOrderingIdx_ == nOrganismsInPopulation_) {
+    if (!population_.canCreateOffspring()) {
+      return -1;
+    }
+    return nOrganismsInPopulation_ + population_.createOffspring();
+  }
   auto isNewGenerationRequired = nextOrderingIdx_ == nOrganismsInPopulation_;
   auto isAllOrderingsReleased = !nUnprocessedOrderings_;
   if (isNewGenerationRequired) {
     if (isAllOrderingsReleased) {
+      endGeneration();
       population_.nextGeneration();
       nUnprocessedOrderings_ = nOrganismsInPopulation_;
       nextOrderingIdx_ = 0;
@@ -45,18 +79,52 @@ OrderingIdx GeneticAlgorithm::reserveOrdering()
   return nextOrderingIdx_++;
 }
 
-ConnectionIdxVec GeneticAlgorithm::getOrdering(OrderingIdx orderingIdx)
+GeneVec GeneticAlgorithm::getGenes(OrderingIdx orderingIdx)
 {
   assert(orderingIdx != -1); // Must wait and try reserveOrdering() again
   assert(nConnectionsInCircuit_); // Must call reset() first
-  return population_.organismVec[orderingIdx].calcConnectionIdxVec();
+  if (orderingIdx >= nOrganismsInPopulation_) {
+    return population_.offspringVec[orderingIdx - nOrganismsInPopulation_]
+        .geneVec;
+  }
+  return population_.organismVec[orderingIdx].geneVec;
+}
+
+// Does not access the population, so does not require the lock.
+ConnectionIdxVec GeneticAlgorithm::calcOrdering(const GeneVec& geneVec)
+{
+  if (encoding_.type == EncodingType::Permutation) {
+    return geneVec;
+  }
+  return topoSort(geneVec);
+}
+
+int GeneticAlgorithm::getNumResets()
+{
+  return nResets_;
 }
 
 void GeneticAlgorithm::releaseOrdering(
-    OrderingIdx orderingIdx, int nCompletedRoutes, long completedRouteCost)
+    OrderingIdx orderingIdx, int nResets, int nCompletedRoutes,
+    long completedRouteCost)
 {
-  population_.organismVec[orderingIdx].nCompletedRoutes = nCompletedRoutes;
-  population_.organismVec[orderingIdx].completedRouteCost = completedRouteCost;
+  if (nResets != nResets_) {
+    return;
+  }
+  if (orderingIdx >= nOrganismsInPopulation_) {
+    OrganismIdx offspringIdx = orderingIdx - nOrganismsInPopulation_;
+    population_.setOffspringFitness(
+        offspringIdx, nCompletedRoutes, completedRouteCost);
+    population_.insertOffspring(offspringIdx);
+    if (++nOffspringInGeneration_ == nOrganismsInPopulation_) {
+      nOffspringInGeneration_ = 0;
+      endGeneration();
+    }
+    return;
+  }
+  population_.setFitness(
+      population_.organismVec[orderingIdx], nCompletedRoutes,
+      completedRouteCost);
   --nUnprocessedOrderings_;
 }
 
@@ -64,3 +132,81 @@ std::unique_lock<std::mutex> GeneticAlgorithm::scopeLock()
 {
   return std::unique_lock<std::mutex>(mutex_);
 }
+
+//
+// Island model
+//
+
+void GeneticAlgorithm::setMigration(
+    MigrationChannel* inbox, MigrationChannel* outbox, int migrationInterval,
+    int nMigrants)
+{
+  assert(migrationInterval > 0);
+  inbox_ = inbox;
+  outbox_ = outbox;
+  migrationInterval_ = migrationInterval;
+  nMigrants_ = nMigrants;
+}
+
+void GeneticAlgorithm::setMigrationEpoch(int migrationEpoch)
+{
+  migrationEpoch_ = migrationEpoch;
+}
+
+PopulationSnapshot GeneticAlgorithm::getSnapshot()
+{
+  return population_.getSnapshot();
+}
+
+// Continue from a checkpoint. Must be called after reset() for the circuit of
+// the checkpoint. The checkpoint may have been saved in the middle of a
+// generation. The restored organisms that had not been evaluated are placed
+// last, so they are handed out first, and a new generation starts when they
+// have all been evaluated. Selection only picks evaluated organisms, so they
+// must all be evaluated before the next generation is created.
+bool GeneticAlgorithm::restore(const PopulationSnapshot& snapshot)
+{
+  if (!population_.restore(snapshot)) {
+    return false;
+  }
+  restart();
+  auto nEvaluatedOrganisms = static_cast<int>(std::count_if(
+      population_.organismVec.begin(), population_.organismVec.end(),
+      [](const Organism& organism) { return organism.isEvaluated; }));
+  nextOrderingIdx_ = nEvaluatedOrganisms;
+  nUnprocessedOrderings_ = nOrganismsInPopulation_ - nEvaluatedOrganisms;
+  return true;
+}
+
+//
+// Private
+//
+
+// Start handing out orderings from the first organism in the population.
+void GeneticAlgorithm::restart()
+{
+  nextOrderingIdx_ = 0;
+  nUnprocessedOrderings_ = nOrganismsInPopulation_;
+  ++nResets_;
+  nGenerations_ = 0;
+  nOffspringInGeneration_ = 0;
+}
+
+void GeneticAlgorithm::endGeneration()
+{
+  ++nGenerations_;
+  if (!inbox_) {
+    return;
+  }
+  MigrationBatch batch;
+  while (inbox_->pop(batch)) {
+    if (batch.migrationEpoch == migrationEpoch_) {
+      population_.immigrate(batch.organismVec);
+    }
+  }
+  if (!(nGenerations_ % migrationInterval_)) {
+    batch.migrationEpoch = migrationEpoch_;
+    batch.organismVec = population_.getFittest(nMigrants_);
+    outbox_->push(std::move(batch));
+  }
+}
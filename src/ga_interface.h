@@ -24,20 +24,28 @@
 // - The client creates a single global instance of GeneticAlgorithm.
 // - The client calls reset() whenever the layout changes, which sets up an
 // initial population with randomized genes.
-// - TODO: When the layout changes, maybe it's better to just keep going on the
-// existing population.
+// - If most of the connections are the same as before the change, the client
+// can instead call warmStart(), which keeps the existing population. The
+// client passes the previous index of each connection, or -1 for new
+// connections.
+// - To continue a search from a checkpoint, the client calls reset() and then
+// restore(), passing a snapshot from getSnapshot().
 // - The object keeps track of how many organisms there are in the
 // population and how many organisms have received fitness scores.
 // - The object has a single lock and before a thread interacts with the
 // object, it must obtain the lock.
 // - A thread first retrieves the index of an ordering by calling
-// reserveOrdering().
-// - The thread then retrieves the actual ordering by calling getOrdering(),
-// passing the index.
+// reserveOrdering(), and the number of resets by calling getNumResets().
+// - The thread then retrieves the genes for the ordering by calling
+// getGenes(), passing the index.
+// - The thread releases the lock and decodes the genes into the actual ordering
+// by calling calcOrdering().
 // - The thread routes the ordering.
 // - The thread releases the ordering and provides the cost of the
-// resulting layout by calling releaseOrdering(), passing the index and the
-// cost.
+// resulting layout by calling releaseOrdering(), passing the index, the number
+// of resets and the cost. An ordering that was reserved before a reset(),
+// warmStart() or restore() is for an organism that no longer exists, so its
+// release is ignored.
 // - When a fitness score has been received for each organism in the population,
 // the creation of a new generation in triggered by the next call to
 // reserveOrdering(). The index for the first ordering in the new generation
@@ -51,6 +59,23 @@
 // In this situation, reserveOrdering() returns the invalid index of -1, at
 // which point the caller must release the lock and wait a bit before trying
 // again.
+//
+// In steady-state mode, there are no generations. Once the initial population
+// has been handed out, each call to reserveOrdering() creates a single
+// offspring from organisms that have already been evaluated, and the offspring
+// replaces a weak organism in the population when its ordering is released.
+// Threads then only have to wait until the first two organisms have been
+// evaluated, instead of at the end of each generation. Offspring orderings get
+// indexes from nOrganismsInPopulation and up.
+//
+// In the island model, there is one GeneticAlgorithm object per island, and
+// each router thread only uses its own island (see IslandModel). At the end of
+// each generation, an island with migration channels accepts migrants from its
+// inbox and, every migrationInterval generations, sends copies of its fittest
+// organisms to its outbox. In steady-state mode, a generation ends after
+// nOrganismsInPopulation offspring have been evaluated. Migrants are only
+// accepted if they were sent in the same migration epoch, which the
+// IslandModel sets for all islands with setMigrationEpoch().
 
 #pragma once
 
@@ -59,6 +84,7 @@
 #include <vector>
 
 #include "ga_core.h"
+#include "migration_channel.h"
 
 typedef int ConnectionIdx;
 typedef std::vector<ConnectionIdx> ConnectionIdxVec;
@@ -68,23 +94,49 @@ class GeneticAlgorithm
 {
   public:
   GeneticAlgorithm(
-      int nOrganismsInPopulation, double crossoverRate, double mutationRate);
-  void reset(int nConnectionsInCircuit);
+      int nOrganismsInPopulation, double crossoverRate, double mutationRate,
+      int randomStreamIdx, const GeneEncoding& encoding);
+  void reset(int nConnectionsInCircuit, bool isSteadyState);
+  void warmStart(
+      const ConnectionIdxVec& prevConnectionIdxVec, bool isSteadyState);
   // Ordering
   OrderingIdx reserveOrdering();
-  ConnectionIdxVec getOrdering(OrderingIdx);
+  GeneVec getGenes(OrderingIdx);
+  ConnectionIdxVec calcOrdering(const GeneVec& geneVec);
+  int getNumResets();
   void releaseOrdering(
-      OrderingIdx, int nCompletedRoutes, long completedRouteCost);
+      OrderingIdx, int nResets, int nCompletedRoutes, long completedRouteCost);
   // Locking
   std::unique_lock<std::mutex> scopeLock();
+  // Island model
+  void setMigration(
+      MigrationChannel* inbox, MigrationChannel* outbox, int migrationInterval,
+      int nMigrants);
+  void setMigrationEpoch(int migrationEpoch);
+  // Checkpoint
+  PopulationSnapshot getSnapshot();
+  bool restore(const PopulationSnapshot& snapshot);
 
   private:
+  void restart();
+  void endGeneration();
+
   int nOrganismsInPopulation_;
+  GeneEncoding encoding_;
   double crossoverRate_;
   double mutationRate_;
   int nConnectionsInCircuit_;
   int nextOrderingIdx_;
   int nUnprocessedOrderings_;
+  bool isSteadyState_;
+  int nResets_;
+  int nGenerations_;
+  int nOffspringInGeneration_;
+  MigrationChannel* inbox_;
+  MigrationChannel* outbox_;
+  int migrationInterval_;
+  int nMigrants_;
+  int migrationEpoch_;
   std::mutex mutex_;
 
   Population population_;
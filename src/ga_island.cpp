@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cassert>
+
+#include "ga_island.h"
+
+IslandModel::IslandModel(
+    int nOrganismsInPopulation, double crossoverRate, double mutationRate)
+  : nOrganismsInPopulation_(nOrganismsInPopulation),
+    crossoverRate_(crossoverRate),
+    mutationRate_(mutationRate),
+    migrationEpoch_(0)
+{
+  init(1, 1, 0, GeneEncoding());
+}
+
+// The population is divided evenly between the islands. Each island must have
+// an even number of organisms, and at least two.
+void IslandModel::init(
+    int nIslands, int migrationInterval, int nMigrants,
+    const GeneEncoding& encoding)
+{
+  assert(nIslands > 0);
+  auto nOrganismsPerIsland =
+      std::max(2, (nOrganismsInPopulation_ / nIslands) & ~1);
+  islandVec_.clear();
+  channelVec_.clear();
+  for (int i = 0; i < nIslands; ++i) {
+    islandVec_.push_back(std::make_unique<GeneticAlgorithm>(
+        nOrganismsPerIsland, crossoverRate_, mutationRate_, i, encoding));
+    channelVec_.push_back(std::make_unique<MigrationChannel>());
+  }
+  if (nIslands == 1) {
+    return;
+  }
+  for (int i = 0; i < nIslands; ++i) {
+    islandVec_[i]->setMigration(
+        channelVec_[i].get(), channelVec_[(i + 1) % nIslands].get(),
+        migrationInterval, nMigrants);
+  }
+}
+
+void IslandModel::reset(int nConnectionsInCircuit, bool isSteadyState)
+{
+  ++migrationEpoch_;
+  for (auto& island : islandVec_) {
+    auto lock = island->scopeLock();
+    island->reset(nConnectionsInCircuit, isSteadyState);
+    island->setMigrationEpoch(migrationEpoch_);
+  }
+}
+
+void IslandModel::warmStart(
+    const ConnectionIdxVec& prevConnectionIdxVec, bool isSteadyState)
+{
+  ++migrationEpoch_;
+  for (auto& island : islandVec_) {
+    auto lock = island->scopeLock();
+    island->warmStart(prevConnectionIdxVec, isSteadyState);
+    island->setMigrationEpoch(migrationEpoch_);
+  }
+}
+
+GeneticAlgorithm& IslandModel::getIsland(int threadIdx)
+{
+  return *islandVec_[threadIdx % islandVec_.size()];
+}
+
+int IslandModel::getNumIslands()
+{
+  return static_cast<int>(islandVec_.size());
+}
+
+// Each island is locked only while its population is copied, so the router
+// threads of the other islands are not held up.
+std::vector<PopulationSnapshot> IslandModel::getSnapshots()
+{
+  std::vector<PopulationSnapshot> snapshotVec;
+  for (auto& island : islandVec_) {
+    auto lock = island->scopeLock();
+    snapshotVec.push_back(island->getSnapshot());
+  }
+  return snapshotVec;
+}
+
+// If the number of islands has changed, the islands are restored from as many
+// snapshots as there are of both, and any remaining islands start from
+// scratch. All the islands move to a new migration epoch, so that restored and
+// remaining islands exchange migrants, while migrants sent before the restore
+// are dropped.
+bool IslandModel::restore(const std::vector<PopulationSnapshot>& snapshotVec)
+{
+  ++migrationEpoch_;
+  for (int i = 0; i < static_cast<int>(islandVec_.size()); ++i) {
+    auto lock = islandVec_[i]->scopeLock();
+    if (i < static_cast<int>(snapshotVec.size())
+        && !islandVec_[i]->restore(snapshotVec[i])) {
+      return false;
+    }
+    islandVec_[i]->setMigrationEpoch(migrationEpoch_);
+  }
+  return true;
+}
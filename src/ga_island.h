@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ga_interface.h"
+#include "migration_channel.h"
+
+// Island model GA. The population is split into islands that evolve
+// independently, each in its own GeneticAlgorithm object. Each router thread
+// uses the island given by its thread index, so with one island per thread,
+// the islands' locks are never contended. The islands are arranged in a ring,
+// and every migrationInterval generations, each island sends copies of its
+// nMigrants fittest organisms to the next island over a MigrationChannel.
+//
+// With a single island, this is the original GA, with a single population
+// shared by all router threads.
+
+class IslandModel
+{
+  public:
+  IslandModel(
+      int nOrganismsInPopulation, double crossoverRate, double mutationRate);
+  // Must be called before the router threads are started.
+  void init(
+      int nIslands, int migrationInterval, int nMigrants,
+      const GeneEncoding& encoding);
+  void reset(int nConnectionsInCircuit, bool isSteadyState);
+  void warmStart(
+      const ConnectionIdxVec& prevConnectionIdxVec, bool isSteadyState);
+  GeneticAlgorithm& getIsland(int threadIdx);
+  int getNumIslands();
+  // Checkpoint
+  std::vector<PopulationSnapshot> getSnapshots();
+  bool restore(const std::vector<PopulationSnapshot>& snapshotVec);
+
+  private:
+  int nOrganismsInPopulation_;
+  double crossoverRate_;
+  double mutationRate_;
+  std::vector<std::unique_ptr<GeneticAlgorithm>> islandVec_;
+  std::vector<std::unique_ptr<MigrationChannel>> channelVec_;
+  // Advanced each time all the islands are reset, warm-started or restored
+  int migrationEpoch_;
+};
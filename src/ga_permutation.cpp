@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#include "ga_permutation.h"
+
+// Random segment [first, last] of the genes
+static void getRandomSegment(
+    int nGenes, RandomEngine& randomEngine, int& first, int& last)
+{
+  first = randomEngine.getRandomInt(0, nGenes - 1);
+  last = randomEngine.getRandomInt(0, nGenes - 1);
+  if (first > last) {
+    std::swap(first, last);
+  }
+}
+
+GeneVec createRandomPermutation(int nGenes, RandomEngine& randomEngine)
+{
+  GeneVec geneVec(nGenes);
+  for (Gene gene = 0; gene < nGenes; ++gene) {
+    geneVec[gene] = gene;
+  }
+  randomEngine.shuffle(geneVec);
+  return geneVec;
+}
+
+// Keep the relative order of the genes that are still in use, and insert the
+// new genes at random positions.
+GeneVec remapPermutation(
+    const GeneVec& geneVec, const GeneVec& newToPrevGeneVec,
+    const GeneVec& prevToNewGeneVec, RandomEngine& randomEngine)
+{
+  GeneVec newGeneVec;
+  for (auto prevGene : geneVec) {
+    if (prevToNewGeneVec[prevGene] != -1) {
+      newGeneVec.push_back(prevToNewGeneVec[prevGene]);
+    }
+  }
+  for (Gene gene = 0; gene < static_cast<int>(newToPrevGeneVec.size());
+       ++gene) {
+    if (newToPrevGeneVec[gene] == -1) {
+      auto pos = randomEngine.getRandomInt(
+          0, static_cast<int>(newGeneVec.size()));
+      newGeneVec.insert(newGeneVec.begin() + pos, gene);
+    }
+  }
+  return newGeneVec;
+}
+
+//
+// Crossover
+//
+
+// OX: The child gets a random segment from a, and the remaining genes in the
+// order in which they appear in b, starting after the segment.
+GeneVec orderCrossover(
+    const GeneVec& a, const GeneVec& b, RandomEngine& randomEngine)
+{
+  int nGenes = static_cast<int>(a.size());
+  int first, last;
+  getRandomSegment(nGenes, randomEngine, first, last);
+  GeneVec childVec(nGenes);
+  std::vector<bool> isUsedVec(nGenes, false);
+  for (int i = first; i <= last; ++i) {
+    childVec[i] = a[i];
+    isUsedVec[a[i]] = true;
+  }
+  int childIdx = (last + 1) % nGenes;
+  for (int i = 0; i < nGenes; ++i) {
+    auto gene = b[(last + 1 + i) % nGenes];
+    if (isUsedVec[gene]) {
+      continue;
+    }
+    childVec[childIdx] = gene;
+    childIdx = (childIdx + 1) % nGenes;
+  }
+  return childVec;
+}
+
+// PMX: The child gets a random segment from a, and the remaining genes from b.
+// Genes from b that are displaced by the segment are placed by following the
+// mapping between a and b within the segment until reaching a position
+// outside of it.
+GeneVec partiallyMappedCrossover(
+    const GeneVec& a, const GeneVec& b, RandomEngine& randomEngine)
+{
+  int nGenes = static_cast<int>(a.size());
+  int first, last;
+  getRandomSegment(nGenes, randomEngine, first, last);
+  std::vector<int> bPosVec(nGenes);
+  for (int i = 0; i < nGenes; ++i) {
+    bPosVec[b[i]] = i;
+  }
+  GeneVec childVec(nGenes, -1);
+  std::vector<bool> isInSegmentVec(nGenes, false);
+  for (int i = first; i <= last; ++i) {
+    childVec[i] = a[i];
+    isInSegmentVec[a[i]] = true;
+  }
+  for (int i = first; i <= last; ++i) {
+    auto gene = b[i];
+    if (isInSegmentVec[gene]) {
+      continue;
+    }
+    int pos = i;
+    while (pos >= first && pos <= last) {
+      pos = bPosVec[a[pos]];
+    }
+    childVec[pos] = gene;
+  }
+  for (int i = 0; i < nGenes; ++i) {
+    if (childVec[i] == -1) {
+      childVec[i] = b[i];
+    }
+  }
+  return childVec;
+}
+
+// ERX: Build the child from the edges (adjacent genes) of both parents. From
+// the current gene, continue with the neighbor that has the fewest remaining
+// neighbors, or with a random unused gene if there are no neighbors left.
+GeneVec edgeRecombinationCrossover(
+    const GeneVec& a, const GeneVec& b, RandomEngine& randomEngine)
+{
+  int nGenes = static_cast<int>(a.size());
+  // Each gene has at most two neighbors in each parent
+  std::vector<std::array<Gene, 4>> neighborArrVec(nGenes);
+  std::vector<int> nNeighborsVec(nGenes, 0);
+  auto addNeighbor = [&](Gene gene, Gene neighbor) {
+    auto& neighborArr = neighborArrVec[gene];
+    auto end = neighborArr.begin() + nNeighborsVec[gene];
+    if (std::find(neighborArr.begin(), end, neighbor) == end) {
+      neighborArr[nNeighborsVec[gene]++] = neighbor;
+    }
+  };
+  for (auto parent : { &a, &b }) {
+    for (int i = 0; i < nGenes; ++i) {
+      auto gene = (*parent)[i];
+      addNeighbor(gene, (*parent)[(i + nGenes - 1) % nGenes]);
+      addNeighbor(gene, (*parent)[(i + 1) % nGenes]);
+    }
+  }
+  // Unused genes, for picking a random one in O(1)
+  GeneVec unusedVec(nGenes);
+  std::vector<int> unusedPosVec(nGenes);
+  for (Gene gene = 0; gene < nGenes; ++gene) {
+    unusedVec[gene] = gene;
+    unusedPosVec[gene] = gene;
+  }
+  auto removeUnused = [&](Gene gene) {
+    auto pos = unusedPosVec[gene];
+    auto lastGene = unusedVec.back();
+    unusedVec[pos] = lastGene;
+    unusedPosVec[lastGene] = pos;
+    unusedVec.pop_back();
+  };
+  GeneVec childVec;
+  childVec.reserve(nGenes);
+  auto gene = a[0];
+  while (true) {
+    childVec.push_back(gene);
+    removeUnused(gene);
+    if (!unusedVec.size()) {
+      break;
+    }
+    for (int i = 0; i < nNeighborsVec[gene]; ++i) {
+      auto neighbor = neighborArrVec[gene][i];
+      auto& neighborArr = neighborArrVec[neighbor];
+      auto end = neighborArr.begin() + nNeighborsVec[neighbor];
+      auto itr = std::find(neighborArr.begin(), end, gene);
+      if (itr != end) {
+        *itr = *(end - 1);
+        --nNeighborsVec[neighbor];
+      }
+    }
+    if (!nNeighborsVec[gene]) {
+      gene = unusedVec[randomEngine.getRandomInt(
+          0, static_cast<int>(unusedVec.size()) - 1)];
+      continue;
+    }
+    Gene nextGene = -1;
+    int nTies = 0;
+    for (int i = 0; i < nNeighborsVec[gene]; ++i) {
+      auto neighbor = neighborArrVec[gene][i];
+      if (nextGene == -1
+          || nNeighborsVec[neighbor] < nNeighborsVec[nextGene]) {
+        nextGene = neighbor;
+        nTies = 1;
+      }
+      else if (nNeighborsVec[neighbor] == nNeighborsVec[nextGene]
+               && !randomEngine.getRandomInt(0, nTies++)) {
+        nextGene = neighbor;
+      }
+    }
+    gene = nextGene;
+  }
+  return childVec;
+}
+
+//
+// Mutation
+//
+
+void swapMutation(GeneVec& geneVec, RandomEngine& randomEngine)
+{
+  int first, last;
+  getRandomSegment(static_cast<int>(geneVec.size()), randomEngine, first, last);
+  std::swap(geneVec[first], geneVec[last]);
+}
+
+// Move a random gene to a random position
+void insertMutation(GeneVec& geneVec, RandomEngine& randomEngine)
+{
+  int nGenes = static_cast<int>(geneVec.size());
+  auto fromIdx = randomEngine.getRandomInt(0, nGenes - 1);
+  auto toIdx = randomEngine.getRandomInt(0, nGenes - 1);
+  if (fromIdx < toIdx) {
+    std::rotate(
+        geneVec.begin() + fromIdx, geneVec.begin() + fromIdx + 1,
+        geneVec.begin() + toIdx + 1);
+  }
+  else {
+    std::rotate(
+        geneVec.begin() + toIdx, geneVec.begin() + fromIdx,
+        geneVec.begin() + fromIdx + 1);
+  }
+}
+
+void inversionMutation(GeneVec& geneVec, RandomEngine& randomEngine)
+{
+  int first, last;
+  getRandomSegment(static_cast<int>(geneVec.size()), randomEngine, first, last);
+  std::reverse(geneVec.begin() + first, geneVec.begin() + last + 1);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "ga_core.h"
+
+// Operators for the permutation encoding, where the genes of an organism are
+// the connection ordering itself. Each operator keeps the genes a valid
+// permutation.
+
+GeneVec createRandomPermutation(int nGenes, RandomEngine& randomEngine);
+GeneVec remapPermutation(
+    const GeneVec& geneVec, const GeneVec& newToPrevGeneVec,
+    const GeneVec& prevToNewGeneVec, RandomEngine& randomEngine);
+
+// Crossover
+GeneVec orderCrossover(
+    const GeneVec& a, const GeneVec& b, RandomEngine& randomEngine);
+GeneVec partiallyMappedCrossover(
+    const GeneVec& a, const GeneVec& b, RandomEngine& randomEngine);
+GeneVec edgeRecombinationCrossover(
+    const GeneVec& a, const GeneVec& b, RandomEngine& randomEngine);
+
+// Mutation
+void swapMutation(GeneVec& geneVec, RandomEngine& randomEngine);
+void insertMutation(GeneVec& geneVec, RandomEngine& randomEngine);
+void inversionMutation(GeneVec& geneVec, RandomEngine& randomEngine);
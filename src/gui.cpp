@@ -25,7 +25,8 @@ Pos getMouseBoardPos(
   return screenToBoardPos(getMouseScrPos(intMousePos), zoom, boardScreenOffset);
 }
 
-std::string getComponentAtBoardPos(Circuit& circuit, const Pos& boardPos)
+std::string getComponentAtBoardPos(
+    const Circuit& circuit, const Pos& boardPos)
 {
   for (auto& ci : circuit.componentNameToComponentMap) {
     auto& componentName = ci.first;
@@ -14,7 +14,8 @@ Pos screenToBoardPos(
 Pos getMouseScrPos(const IntPos& intMousePos);
 Pos getMouseBoardPos(
     const IntPos& intMousePos, const float zoom, const Pos& boardScreenOffset);
-std::string getComponentAtBoardPos(Circuit& circuit, const Pos& boardPos);
+std::string getComponentAtBoardPos(
+    const Circuit& circuit, const Pos& boardPos);
 void setComponentPosition(
     Circuit& circuit, const Via& mouseBoardVia,
     const std::string& componentName);
@@ -19,6 +19,11 @@ void GuiStatus::reset()
   nCombinationsChecked = 0;
   nCheckedPerSec = 0.0f;
 
+  nRoutesPerSec = 0.0f;
+  nExpandedNodesPerSec = 0.0f;
+  routingPercent = 0.0f;
+  lockWaitPercent = 0.0f;
+
   nCurrentCompletedRoutes = 0;
   nCurrentFailedRoutes = 0.0;
   currentCost = 0;
@@ -67,6 +72,31 @@ void GuiStatus::init(nanogui::Screen* screen)
     w->setFixedWidth(70);
     w->numberFormat("%.2f");
   }
+  form_->addGroup("Router Threads");
+  {
+    auto w = form_->addVariable("Routes/s", nRoutesPerSec);
+    w->setEditable(false);
+    w->setFixedWidth(70);
+    w->numberFormat("%.1f");
+  }
+  {
+    auto w = form_->addVariable("Nodes/s", nExpandedNodesPerSec);
+    w->setEditable(false);
+    w->setFixedWidth(70);
+    w->numberFormat("%.0f");
+  }
+  {
+    auto w = form_->addVariable("Routing %", routingPercent);
+    w->setEditable(false);
+    w->setFixedWidth(70);
+    w->numberFormat("%.1f");
+  }
+  {
+    auto w = form_->addVariable("Lock wait %", lockWaitPercent);
+    w->setEditable(false);
+    w->setFixedWidth(70);
+    w->numberFormat("%.2f");
+  }
   form_->addGroup("Current Layout");
   {
     auto w = form_->addVariable("Completed", groupedStrCurrentCompletedRoutes);
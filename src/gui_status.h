@@ -18,9 +18,15 @@ class GuiStatus
 
   float msPerFrame;
 
-  int nCombinationsChecked;
+  long nCombinationsChecked;
   float nCheckedPerSec;
 
+  // Router threads
+  float nRoutesPerSec;
+  float nExpandedNodesPerSec;
+  float routingPercent;
+  float lockWaitPercent;
+
   int nCurrentCompletedRoutes;
   double nCurrentFailedRoutes;
   double currentCost;
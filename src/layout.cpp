@@ -2,16 +2,19 @@
 
 #include "layout.h"
 
+LayoutInput::LayoutInput() : gridW(0), gridH(0)
+{
+}
+
 Layout::Layout()
-  : gridW(0),
-    gridH(0),
-    cost(0),
+  : cost(0),
     nCompletedRoutes(0),
     nFailedRoutes(0),
     numShortcuts(0),
     isReadyForRouting(false),
     isReadyForEval(false),
-    hasError(false)
+    hasError(false),
+    input_(std::make_shared<LayoutInput>())
 {
   updateBaseTimestamp();
 }
@@ -29,10 +32,7 @@ Layout& Layout::operator=(const Layout& s)
 
 void Layout::copy(const Layout& s)
 {
-  circuit = s.circuit;
-  settings = s.settings;
-  gridW = s.gridW;
-  gridH = s.gridH;
+  input_ = s.input_;
   cost = s.cost;
   nCompletedRoutes = s.nCompletedRoutes;
   nFailedRoutes = s.nFailedRoutes;
@@ -45,8 +45,8 @@ void Layout::copy(const Layout& s)
   stripCutVec = s.stripCutVec;
   routeStatusVec = s.routeStatusVec;
   // Nets
-  viaSetVec = s.viaSetVec;
-  setIdxVec = s.setIdxVec;
+  netParentIdxVec = s.netParentIdxVec;
+  netRankVec = s.netRankVec;
   // Debug
   diagStartVia = s.diagStartVia;
   diagEndVia = s.diagEndVia;
@@ -63,12 +63,12 @@ void Layout::updateBaseTimestamp()
   timestamp_ = std::chrono::high_resolution_clock::now();
 }
 
-bool Layout::isBasedOn(const Layout& other)
+bool Layout::isBasedOn(const Layout& other) const
 {
   return timestamp_ == other.timestamp_;
 }
 
-Timestamp& Layout::getBaseTimestamp()
+const Timestamp& Layout::getBaseTimestamp() const
 {
   return timestamp_;
 }
@@ -103,7 +103,38 @@ bool Layout::isLocked()
   return wasLocked;
 }
 
-int Layout::idx(const Via& v)
+const Circuit& Layout::circuit() const
+{
+  return input_->circuit;
+}
+
+const Settings& Layout::settings() const
+{
+  return input_->settings;
+}
+
+int Layout::gridW() const
+{
+  return input_->gridW;
+}
+
+int Layout::gridH() const
+{
+  return input_->gridH;
+}
+
+// Return the input for modification. If the input is shared with other
+// layouts, this layout first gets its own copy, so the other layouts are not
+// affected. Only the layout that is modified needs to be locked.
+LayoutInput& Layout::editInput()
+{
+  if (input_.use_count() > 1) {
+    input_ = std::make_shared<LayoutInput>(*input_);
+  }
+  return *input_;
+}
+
+int Layout::idx(const Via& v) const
 {
-  return v.x() + gridW * v.y();
+  return v.x() + input_->gridW * v.y();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_set>
@@ -20,11 +21,25 @@ typedef std::vector<Via> StripCutVec;
 // Nets
 // typedef std::set<Via, std::function<bool(const Via&, const Via&)> > ViaSet;
 typedef std::unordered_set<Via> ViaSet;
-typedef std::vector<ViaSet> ViaSetVec;
 typedef std::vector<int> SetIdxVec;
+typedef std::vector<unsigned char> NetRankVec;
 
 typedef std::chrono::time_point<std::chrono::high_resolution_clock> Timestamp;
 
+// The circuit, settings and grid size that a layout is routed for. Copies of a
+// Layout share a single LayoutInput, which is never modified while it is
+// shared, so copying a Layout only copies the routing result.
+
+class LayoutInput
+{
+  public:
+  LayoutInput();
+  Circuit circuit;
+  Settings settings;
+  int gridW;
+  int gridH;
+};
+
 class Layout
 {
   public:
@@ -33,20 +48,20 @@ class Layout
   Layout& operator=(const Layout&);
   // Lineage
   void updateBaseTimestamp();
-  bool isBasedOn(const Layout& other);
-  Timestamp& getBaseTimestamp();
+  bool isBasedOn(const Layout& other) const;
+  const Timestamp& getBaseTimestamp() const;
   // Locking
   std::unique_lock<std::mutex> scopeLock();
   Layout threadSafeCopy();
   bool isLocked();
+  // Input
+  const Circuit& circuit() const;
+  const Settings& settings() const;
+  int gridW() const;
+  int gridH() const;
+  LayoutInput& editInput();
   //
-  int idx(const Via&);
-
-  Circuit circuit;
-  Settings settings;
-
-  int gridW;
-  int gridH;
+  int idx(const Via&) const;
 
   long cost;
   int nCompletedRoutes;
@@ -63,8 +78,8 @@ class Layout
   RouteStatusVec routeStatusVec;
 
   // Nets
-  ViaSetVec viaSetVec;
-  SetIdxVec setIdxVec;
+  SetIdxVec netParentIdxVec;
+  NetRankVec netRankVec;
 
   // Debug
   ValidVia diagStartVia;
@@ -76,6 +91,7 @@ class Layout
 
   private:
   void copy(const Layout& s);
+  std::shared_ptr<LayoutInput> input_;
   std::mutex mutex_;
   Timestamp timestamp_;
 };
@@ -0,0 +1,165 @@
+#include <climits>
+#include <cmath>
+
+#include "ga_permutation.h"
+#include "local_search.h"
+
+const long FAILED_ROUTE_ENERGY = 1000000;
+// Simulated annealing
+const double INITIAL_TEMPERATURE = 100.0;
+const double MIN_TEMPERATURE = 1.0;
+const double COOLING_FACTOR = 0.999;
+// Iterated local search
+const int MOVES_PER_CONNECTION_IN_LOCAL_OPTIMUM = 2;
+const int PERTURBATION_MOVES = 4;
+
+//
+// LocalSearch
+//
+
+LocalSearch::LocalSearch(int randomStreamIdx)
+  : randomEngine_(getRandomSeed(), randomStreamIdx),
+    nConnectionsInCircuit_(0),
+    currentEnergy_(LONG_MAX),
+    bestEnergy_(LONG_MAX),
+    randomStreamIdx_(randomStreamIdx),
+    nResets_(0),
+    isReserved_(false)
+{
+}
+
+// The search starts by evaluating a random ordering.
+void LocalSearch::reset(int nConnectionsInCircuit)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  randomEngine_ = RandomEngine(getRandomSeed(), randomStreamIdx_);
+  nConnectionsInCircuit_ = nConnectionsInCircuit;
+  ++nResets_;
+  isReserved_ = false;
+  currentVec_ = createRandomPermutation(nConnectionsInCircuit, randomEngine_);
+  currentEnergy_ = LONG_MAX;
+  candidateVec_ = currentVec_;
+  bestVec_ = currentVec_;
+  bestEnergy_ = LONG_MAX;
+  resetSearch();
+}
+
+// There is a single candidate at a time.
+OrderingIdx LocalSearch::reserveOrdering()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!nConnectionsInCircuit_ || isReserved_) {
+    return -1;
+  }
+  isReserved_ = true;
+  return nResets_;
+}
+
+ConnectionIdxVec LocalSearch::getOrdering(OrderingIdx)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return candidateVec_;
+}
+
+void LocalSearch::releaseOrdering(
+    OrderingIdx orderingIdx, int nCompletedRoutes, long completedRouteCost)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orderingIdx != nResets_) {
+    return;
+  }
+  isReserved_ = false;
+  auto candidateEnergy =
+      (nConnectionsInCircuit_ - nCompletedRoutes) * FAILED_ROUTE_ENERGY
+      + completedRouteCost;
+  if (candidateEnergy < bestEnergy_) {
+    bestVec_ = candidateVec_;
+    bestEnergy_ = candidateEnergy;
+  }
+  evaluated(candidateEnergy);
+}
+
+void LocalSearch::setNeighborCandidate()
+{
+  candidateVec_ = currentVec_;
+  if (randomEngine_.getRandomInt(0, 1)) {
+    swapMutation(candidateVec_, randomEngine_);
+  }
+  else {
+    insertMutation(candidateVec_, randomEngine_);
+  }
+}
+
+//
+// SimulatedAnnealing
+//
+
+SimulatedAnnealing::SimulatedAnnealing(int randomStreamIdx)
+  : LocalSearch(randomStreamIdx), temperature_(INITIAL_TEMPERATURE)
+{
+}
+
+void SimulatedAnnealing::evaluated(long candidateEnergy)
+{
+  auto delta = static_cast<double>(candidateEnergy)
+               - static_cast<double>(currentEnergy_);
+  if (delta <= 0.0
+      || randomEngine_.getNormalizedRandom() < std::exp(-delta / temperature_)) {
+    currentVec_.swap(candidateVec_);
+    currentEnergy_ = candidateEnergy;
+  }
+  temperature_ *= COOLING_FACTOR;
+  if (temperature_ < MIN_TEMPERATURE) {
+    temperature_ = INITIAL_TEMPERATURE;
+    currentVec_ = bestVec_;
+    currentEnergy_ = bestEnergy_;
+  }
+  setNeighborCandidate();
+}
+
+void SimulatedAnnealing::resetSearch()
+{
+  temperature_ = INITIAL_TEMPERATURE;
+}
+
+//
+// IteratedLocalSearch
+//
+
+IteratedLocalSearch::IteratedLocalSearch(int randomStreamIdx)
+  : LocalSearch(randomStreamIdx), nMovesWithoutImprovement_(0)
+{
+}
+
+void IteratedLocalSearch::evaluated(long candidateEnergy)
+{
+  if (candidateEnergy < currentEnergy_) {
+    nMovesWithoutImprovement_ = 0;
+  }
+  else {
+    ++nMovesWithoutImprovement_;
+  }
+  if (candidateEnergy <= currentEnergy_) {
+    currentVec_.swap(candidateVec_);
+    currentEnergy_ = candidateEnergy;
+  }
+  if (nMovesWithoutImprovement_
+      < MOVES_PER_CONNECTION_IN_LOCAL_OPTIMUM * nConnectionsInCircuit_) {
+    setNeighborCandidate();
+    return;
+  }
+  // The perturbed ordering becomes the new starting point, so it is evaluated
+  // and accepted unconditionally.
+  nMovesWithoutImprovement_ = 0;
+  currentVec_ = bestVec_;
+  currentEnergy_ = LONG_MAX;
+  for (int i = 0; i < PERTURBATION_MOVES; ++i) {
+    insertMutation(currentVec_, randomEngine_);
+  }
+  candidateVec_ = currentVec_;
+}
+
+void IteratedLocalSearch::resetSearch()
+{
+  nMovesWithoutImprovement_ = 0;
+}
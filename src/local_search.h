@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mutex>
+
+#include "search_strategy.h"
+
+// Single solution search over connection orderings. The neighbors of an
+// ordering are the orderings reached by swapping two connections or by moving
+// one connection to another position. Each router thread runs its own
+// independent search.
+//
+// The fitness of a layout is turned into an energy to minimize, where each
+// failed route weighs more than any difference in cost.
+
+class LocalSearch : public SearchStrategy
+{
+  public:
+  LocalSearch(int randomStreamIdx);
+  void reset(int nConnectionsInCircuit) override;
+  OrderingIdx reserveOrdering() override;
+  ConnectionIdxVec getOrdering(OrderingIdx orderingIdx) override;
+  void releaseOrdering(
+      OrderingIdx orderingIdx, int nCompletedRoutes,
+      long completedRouteCost) override;
+
+  protected:
+  // Called with the energy of candidateVec_. Must set up the next candidate.
+  virtual void evaluated(long candidateEnergy) = 0;
+  virtual void resetSearch() = 0;
+  void setNeighborCandidate();
+
+  RandomEngine randomEngine_;
+  int nConnectionsInCircuit_;
+  // The search is at currentVec_ and is evaluating candidateVec_
+  ConnectionIdxVec currentVec_;
+  long currentEnergy_;
+  ConnectionIdxVec candidateVec_;
+  ConnectionIdxVec bestVec_;
+  long bestEnergy_;
+
+  private:
+  std::mutex mutex_;
+  int randomStreamIdx_;
+  // Orderings released after a reset() are ignored.
+  int nResets_;
+  bool isReserved_;
+};
+
+// Simulated annealing: A worse neighbor is accepted with a probability that
+// decreases with the difference in energy and with the temperature. The
+// temperature is lowered after each step. When it reaches the minimum, the
+// search reheats and restarts from the best ordering found.
+class SimulatedAnnealing : public LocalSearch
+{
+  public:
+  SimulatedAnnealing(int randomStreamIdx);
+
+  protected:
+  void evaluated(long candidateEnergy) override;
+  void resetSearch() override;
+
+  private:
+  double temperature_;
+};
+
+// Iterated local search: Neighbors that are no worse are accepted. When no
+// better neighbor has been found for a while, the search is assumed to be in a
+// local optimum, and restarts from a random perturbation of the best ordering
+// found.
+class IteratedLocalSearch : public LocalSearch
+{
+  public:
+  IteratedLocalSearch(int randomStreamIdx);
+
+  protected:
+  void evaluated(long candidateEnergy) override;
+  void resetSearch() override;
+
+  private:
+  int nMovesWithoutImprovement_;
+};
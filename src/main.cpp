@@ -1,12 +1,17 @@
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <climits>
 #include <cstdio>
+#include <cstdlib>
 #include <ctime>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 #if defined(_WIN32)
@@ -24,17 +29,26 @@
 
 #include "circuit_parser.h"
 #include "circuit_writer.h"
-#include "ga_interface.h"
+#include "fitness_cache.h"
+#include "ga_island.h"
 #include "gl_error.h"
 #include "gui.h"
 #include "gui_status.h"
 #include "icon.h"
+#include "local_search.h"
 #include "ogl_text.h"
+#include "published_layout.h"
+#include "random_engine.h"
 #include "render.h"
+#include "route_cache.h"
 #include "router.h"
+#include "search_checkpoint.h"
+#include "search_strategy.h"
 #include "status.h"
+#include "thread_affinity.h"
 #include "utils.h"
 #include "via.h"
+#include "work_signal.h"
 #include "write_svg.h"
 
 using namespace std::chrono_literals;
@@ -75,26 +89,52 @@ GuiStatus guiStatus;
 
 // Threads
 // TODO: Consider https://github.com/vit-vit/ctpl
-#ifndef NDEBUG
-const int N_ROUTER_THREADS = 1;
-#else
-const int N_ROUTER_THREADS = std::thread::hardware_concurrency();
-#endif
+// The number of router threads is set on the command line. By default, there
+// is one per core, except for cores reserved for the GUI thread.
+int nRouterThreads;
+int nReservedCores;
+bool usePinnedThreads;
+void pinMainThread();
 
 // Router threads
 const std::chrono::duration<double> maxRenderDelay = 30s;
-std::vector<std::thread> routerThreadVec(N_ROUTER_THREADS);
+std::vector<std::thread> routerThreadVec;
 ThreadStop threadStopRouter;
+// Notified when the input layout changes, when an ordering is released and on
+// stop, which are the events that can give an idle router thread work.
+WorkSignal routerWorkSignal;
+
+// Router states for ordering prefixes, shared by the router threads
+const int ROUTE_CACHE_MAX_ENTRIES = 1024;
+const int ROUTE_CACHE_SNAPSHOT_INTERVAL = 4;
+RouteCache routeCache(ROUTE_CACHE_MAX_ENTRIES, ROUTE_CACHE_SNAPSHOT_INTERVAL);
+
+// Fitness of routed orderings, shared by the router threads
+const long DEFAULT_FITNESS_CACHE_MB = 64;
+FitnessCache fitnessCache(DEFAULT_FITNESS_CACHE_MB * 1024 * 1024);
 void stopRouterThreads();
-void routerThread();
+void routerThread(int threadIdx);
 void launchRouterThreads();
 
 // CircuitFileParser thread
 std::thread parserThreadObj;
 ThreadStop threadStopParser;
+// Notified when the parser is unpaused and on stop
+WorkSignal parserWorkSignal;
 void stopParserThread();
 void parserThread();
 void launchParserThread();
+void unpauseParser();
+
+// Search checkpoint thread
+std::thread checkpointThreadObj;
+ThreadStop threadStopCheckpoint;
+// Notified on stop
+WorkSignal checkpointWorkSignal;
+void stopCheckpointThread();
+void checkpointThread();
+void launchCheckpointThread();
+void saveSearchCheckpoint();
 
 // Drag / drop
 bool isComponentDragActive = false;
@@ -109,8 +149,10 @@ void renderDragStatus(IntPos mouseScrPos);
 
 // Shared objects
 Layout inputLayout;
-Layout currentLayout;
-Layout bestLayout;
+// Advanced on each change to inputLayout
+LayoutGeneration inputLayoutGeneration;
+PublishedLayout currentLayout;
+PublishedLayout bestLayout;
 
 // Genetic Algorithm
 #ifndef NDEBUG
@@ -120,8 +162,40 @@ const int N_ORGANISMS_IN_POPULATION = 1000;
 #endif
 const double CROSSOVER_RATE = 0.7;
 const double MUTATION_RATE = 0.01;
-GeneticAlgorithm geneticAlgorithm(
+const int DEFAULT_MIGRATION_INTERVAL = 10;
+const int DEFAULT_N_MIGRANTS = 5;
+IslandModel islandModel(
     N_ORGANISMS_IN_POPULATION, CROSSOVER_RATE, MUTATION_RATE);
+// The connections for which the GA population was evolved
+ConnectionVec gaConnectionVec;
+// Search strategy, one object per router thread
+std::string searchStrategyName;
+std::vector<std::unique_ptr<SearchStrategy>> searchStrategyVec;
+std::unique_ptr<SearchStrategy> createSearchStrategy(int threadIdx);
+ConnectionIdxVec calcPrevConnectionIdxVec(
+    const ConnectionVec& prevConnectionVec, const ConnectionVec& connectionVec);
+
+// Search checkpoints
+// The ordering of the best layout, and the input layout generation it was
+// routed for
+std::mutex bestOrderingMutex;
+ConnectionIdxVec bestConnectionIdxVec;
+unsigned long bestOrderingGeneration = 0;
+int bestNCompletedRoutes = 0;
+long bestCost = 0;
+void updateBestOrdering(
+    unsigned long generation, const ConnectionIdxVec& connectionIdxVec,
+    int nCompletedRoutes, long cost);
+// Checkpoint loaded with --resume. It is applied to the first input layout
+// that is ready for routing.
+std::unique_ptr<SearchCheckpoint> resumeCheckpoint;
+// The best ordering from the checkpoint, which is routed first to restore the
+// best layout
+ConnectionIdxVec resumeConnectionIdxVec;
+unsigned long resumeOrderingGeneration = 0;
+bool takeResumeOrdering(
+    unsigned long generation, ConnectionIdxVec& connectionIdxVec);
+void resumeSearch();
 
 // Misc
 Render render;
@@ -132,6 +206,7 @@ std::string CIRCUIT_FILE_PATH = "./circuits/example.circuit";
 // Status
 Status status;
 void printStats();
+std::atomic<long> nextCheckpointAtNumChecks;
 TrackAverage averageRenderTime(60);
 TrackAverage averageFailedRoutes(N_ORGANISMS_IN_POPULATION);
 
@@ -140,16 +215,32 @@ ThreadStop threadStopApp;
 void runHeadless();
 void runGui();
 void exitApp();
-volatile bool isParserPaused = true;
+std::atomic<bool> isAppExiting(false);
+std::atomic<bool> isParserPaused(true);
 
 // Command line args
 void parseCommandLineArgs(int argc, char** argv);
+void applyCommandLineSettings(Settings& settings);
+GeneEncoding parseGeneEncoding(
+    const std::string& encodingStr, const std::string& crossoverStr,
+    const std::string& mutationStr);
+void loadResumeCheckpoint(bool isSeedSet);
 bool noGui;
-bool useRandomSearch;
+bool useAStar;
+bool useBucketQueue;
+bool useRunEdges;
+bool useBidirectional;
+bool useRouteBound;
+bool useRouteCache;
+bool useFitnessCache;
+bool useSteadyStateGa;
 bool exitOnFirstComplete;
 long exitAfterNumChecks;
 long checkpointAtNumChecks;
 std::string circuitFilePath;
+std::string checkpointFilePath;
+long checkpointIntervalSec;
+GeneEncoding geneEncoding;
 
 class Application : public nanogui::Screen
 {
@@ -199,12 +290,12 @@ class Application : public nanogui::Screen
           "Wire",
           [&](int v) {
             auto lock = inputLayout.scopeLock();
-            inputLayout.settings.wire_cost = v;
+            inputLayout.editInput().settings.wire_cost = v;
             resetInputLayout();
           },
           [&]() {
             auto lock = inputLayout.scopeLock();
-            return inputLayout.settings.wire_cost;
+            return inputLayout.settings().wire_cost;
           });
       w->setSpinnable(true);
       w->setMinValue(1);
@@ -215,12 +306,12 @@ class Application : public nanogui::Screen
           "Strip",
           [&](int v) {
             auto lock = inputLayout.scopeLock();
-            inputLayout.settings.strip_cost = v;
+            inputLayout.editInput().settings.strip_cost = v;
             resetInputLayout();
           },
           [&]() {
             auto lock = inputLayout.scopeLock();
-            return inputLayout.settings.strip_cost;
+            return inputLayout.settings().strip_cost;
           });
       w->setSpinnable(true);
       w->setMinValue(1);
@@ -231,12 +322,12 @@ class Application : public nanogui::Screen
           "Via",
           [&](int v) {
             auto lock = inputLayout.scopeLock();
-            inputLayout.settings.via_cost = v;
+            inputLayout.editInput().settings.via_cost = v;
             resetInputLayout();
           },
           [&]() {
             auto lock = inputLayout.scopeLock();
-            return inputLayout.settings.via_cost;
+            return inputLayout.settings().via_cost;
           });
       w->setSpinnable(true);
       w->setMinValue(1);
@@ -247,17 +338,108 @@ class Application : public nanogui::Screen
           "Cut",
           [&](int v) {
             auto lock = inputLayout.scopeLock();
-            inputLayout.settings.cut_cost = v;
+            inputLayout.editInput().settings.cut_cost = v;
             resetInputLayout();
           },
           [&]() {
             auto lock = inputLayout.scopeLock();
-            return inputLayout.settings.cut_cost;
+            return inputLayout.settings().cut_cost;
           });
       w->setSpinnable(true);
       w->setMinValue(1);
       w->setValueIncrement(1);
     }
+    form->addGroup("Search");
+    {
+      form->addVariable<bool>(
+          "A*",
+          [&](bool v) {
+            auto lock = inputLayout.scopeLock();
+            inputLayout.editInput().settings.use_astar = v;
+            resetInputLayout();
+          },
+          [&]() {
+            auto lock = inputLayout.scopeLock();
+            return inputLayout.settings().use_astar;
+          });
+      form->addVariable<bool>(
+          "Bucket queue",
+          [&](bool v) {
+            auto lock = inputLayout.scopeLock();
+            inputLayout.editInput().settings.use_bucket_queue = v;
+            resetInputLayout();
+          },
+          [&]() {
+            auto lock = inputLayout.scopeLock();
+            return inputLayout.settings().use_bucket_queue;
+          });
+      form->addVariable<bool>(
+          "Run edges",
+          [&](bool v) {
+            auto lock = inputLayout.scopeLock();
+            inputLayout.editInput().settings.use_run_edges = v;
+            resetInputLayout();
+          },
+          [&]() {
+            auto lock = inputLayout.scopeLock();
+            return inputLayout.settings().use_run_edges;
+          });
+      form->addVariable<bool>(
+          "Bidirectional",
+          [&](bool v) {
+            auto lock = inputLayout.scopeLock();
+            inputLayout.editInput().settings.use_bidirectional = v;
+            resetInputLayout();
+          },
+          [&]() {
+            auto lock = inputLayout.scopeLock();
+            return inputLayout.settings().use_bidirectional;
+          });
+      form->addVariable<bool>(
+          "Route bound",
+          [&](bool v) {
+            auto lock = inputLayout.scopeLock();
+            inputLayout.editInput().settings.use_route_bound = v;
+            resetInputLayout();
+          },
+          [&]() {
+            auto lock = inputLayout.scopeLock();
+            return inputLayout.settings().use_route_bound;
+          });
+      form->addVariable<bool>(
+          "Route cache",
+          [&](bool v) {
+            auto lock = inputLayout.scopeLock();
+            inputLayout.editInput().settings.use_route_cache = v;
+            resetInputLayout();
+          },
+          [&]() {
+            auto lock = inputLayout.scopeLock();
+            return inputLayout.settings().use_route_cache;
+          });
+      form->addVariable<bool>(
+          "Fitness cache",
+          [&](bool v) {
+            auto lock = inputLayout.scopeLock();
+            inputLayout.editInput().settings.use_fitness_cache = v;
+            resetInputLayout();
+          },
+          [&]() {
+            auto lock = inputLayout.scopeLock();
+            return inputLayout.settings().use_fitness_cache;
+          });
+      form->addVariable<bool>(
+          "Steady-state GA",
+          [&](bool v) {
+            auto lock = inputLayout.scopeLock();
+            inputLayout.editInput().settings.use_steady_state_ga = v;
+            resetInputLayout();
+          },
+          [&]() {
+            auto lock = inputLayout.scopeLock();
+            return inputLayout.settings().use_steady_state_ga;
+          });
+    }
     form->addGroup("Display");
     form->addVariable("Rat's Nest", isShowRatsNestEnabled);
     form->addVariable("Only Failed", isShowOnlyFailedEnabled);
@@ -273,7 +455,8 @@ class Application : public nanogui::Screen
         auto upperLeftPos =
             boardToScrPos(Pos(0.0f, 0.0f), zoom, panOffsetScrPos);
         auto lowerRightPos = boardToScrPos(
-            Pos(inputLayout.gridW, inputLayout.gridH), zoom, panOffsetScrPos);
+            Pos(inputLayout.gridW(), inputLayout.gridH()), zoom,
+            panOffsetScrPos);
         auto centerBoardPos =
             upperLeftPos + (lowerRightPos - upperLeftPos) / 2.0f;
         setZoomPan(centerBoardPos);
@@ -285,11 +468,12 @@ class Application : public nanogui::Screen
           "Pause",
           [&](bool v) {
             auto lock = inputLayout.scopeLock();
-            inputLayout.settings.pause = v;
+            inputLayout.editInput().settings.pause = v;
+            routerWorkSignal.notify();
           },
           [&]() {
             auto lock = inputLayout.scopeLock();
-            return inputLayout.settings.pause;
+            return inputLayout.settings().pause;
           });
     }
     form->addGroup("Input Layout");
@@ -297,7 +481,7 @@ class Application : public nanogui::Screen
       saveInputLayoutButton = form->addButton("Save to .circuit file", []() {
         CircuitFileWriter fileWriter;
         fileWriter.updateComponentPositions(
-            circuitFilePath, inputLayout.circuit);
+            circuitFilePath, inputLayout.circuit());
         saveInputLayoutButton->setEnabled(false);
       });
       saveInputLayoutButton->setEnabled(false);
@@ -305,7 +489,8 @@ class Application : public nanogui::Screen
     form->addGroup("Best Layout");
     {
       saveBestLayoutButton = form->addButton("Save to .svg files", [this]() {
-        SvgWriter svgWriter(bestLayout);
+        auto layout = bestLayout.get();
+        SvgWriter svgWriter(*layout);
         auto svgPathVec = svgWriter.writeFiles(circuitFilePath);
         std::stringstream ss;
         ss << "Wrote .svg (Scalable Vector Graphics) files:\n\n";
@@ -340,7 +525,7 @@ class Application : public nanogui::Screen
       {
         auto lock = inputLayout.scopeLock();
         componentName = getComponentAtBoardPos(
-            inputLayout.circuit,
+            inputLayout.circuit(),
             getMouseBoardPos(mousePos(), zoom, panOffsetScrPos));
       }
       if (componentName != "") {
@@ -349,9 +534,10 @@ class Application : public nanogui::Screen
         dragComponentName = componentName;
         {
           auto lock = inputLayout.scopeLock();
+          const auto& componentMap =
+              inputLayout.circuit().componentNameToComponentMap;
           auto pin0BoardPos =
-              inputLayout.circuit.componentNameToComponentMap[componentName]
-                  .pin0AbsPos.cast<float>();
+              componentMap.at(componentName).pin0AbsPos.cast<float>();
           dragPin0BoardOffset =
               getMouseBoardPos(mousePos(), zoom, panOffsetScrPos)
               - pin0BoardPos;
@@ -390,7 +576,7 @@ class Application : public nanogui::Screen
     setZoomPan(getMouseScrPos(mousePos()));
     // zoom towards center of board
     //    auto lock = inputLayout.scopeLock();
-    //    Pos centerBoardPos(inputLayout.gridW / 2.0f, inputLayout.gridH /
+    //    Pos centerBoardPos(inputLayout.gridW() / 2.0f, inputLayout.gridH() /
     //    2.0f);
     //    setZoomPan(boardToScrPos(centerBoardPos, zoom, panOffsetScrPos));
     return true;
@@ -445,29 +631,31 @@ class Application : public nanogui::Screen
     guiStatus.msPerFrame = avgRenderingSec * 1000;
     // Status
     {
-      auto inputLock = inputLayout.scopeLock();
-      std::lock_guard<std::mutex> lockStatus(statusMutex);
-      auto nowTimestamp = std::chrono::high_resolution_clock::now();
-      auto layoutElapsed = nowTimestamp - inputLayout.getBaseTimestamp();
-      auto layoutElapsedSec =
-          std::chrono::duration_cast<std::chrono::milliseconds>(layoutElapsed)
-              .count()
-          / 1000.0f;
-      guiStatus.nCombinationsChecked = status.nCombinationsChecked;
-      if (layoutElapsedSec > 0) {
+      auto totalCounts = status.getTotalCounts();
+      auto elapsedSec = status.getElapsedSec();
+      guiStatus.nCombinationsChecked = totalCounts.nCombinationsChecked;
+      if (elapsedSec > 0) {
+        auto threadSec = elapsedSec * status.getNumThreads();
         guiStatus.nCheckedPerSec =
-            status.nCombinationsChecked / layoutElapsedSec;
+            totalCounts.nCombinationsChecked / elapsedSec;
+        guiStatus.nRoutesPerSec = totalCounts.nRoutes / elapsedSec;
+        guiStatus.nExpandedNodesPerSec =
+            totalCounts.nExpandedNodes / elapsedSec;
+        guiStatus.routingPercent =
+            100 * totalCounts.routingTime.count() / 1e9 / threadSec;
+        guiStatus.lockWaitPercent =
+            100 * totalCounts.lockWaitTime.count() / 1e9 / threadSec;
       }
     }
     // Current
     {
+      auto layout = currentLayout.get();
       auto inputLock = inputLayout.scopeLock();
-      auto currentLock = currentLayout.scopeLock();
-      if (currentLayout.isBasedOn(inputLayout)) {
-        guiStatus.nCurrentCompletedRoutes = currentLayout.nCompletedRoutes;
-        guiStatus.currentCost = currentLayout.cost;
+      if (layout->isBasedOn(inputLayout)) {
+        guiStatus.nCurrentCompletedRoutes = layout->nCompletedRoutes;
+        guiStatus.currentCost = layout->cost;
 
-        averageFailedRoutes.addValue(currentLayout.nFailedRoutes);
+        averageFailedRoutes.addValue(layout->nFailedRoutes);
         guiStatus.nCurrentFailedRoutes = averageFailedRoutes.calcAverage();
       }
       else {
@@ -478,12 +666,12 @@ class Application : public nanogui::Screen
     }
     // Best
     {
+      auto layout = bestLayout.get();
       auto inputLock = inputLayout.scopeLock();
-      auto bestLock = bestLayout.scopeLock();
-      if (bestLayout.isBasedOn(inputLayout)) {
-        guiStatus.nBestCompletedRoutes = bestLayout.nCompletedRoutes;
-        guiStatus.nBestFailedRoutes = bestLayout.nFailedRoutes;
-        guiStatus.bestCost = bestLayout.cost;
+      if (layout->isBasedOn(inputLayout)) {
+        guiStatus.nBestCompletedRoutes = layout->nCompletedRoutes;
+        guiStatus.nBestFailedRoutes = layout->nFailedRoutes;
+        guiStatus.bestCost = layout->cost;
       }
       else {
         guiStatus.nBestCompletedRoutes = 0;
@@ -507,28 +695,31 @@ class Application : public nanogui::Screen
 
     handleMouseDragOperations(mousePos());
 
-    // Select which layout to render and render a copy of it to avoid locking
-    // the layout during the render time, which could hold up the router
-    // threads.
+    // Select which layout to render. The input layout is copied to avoid
+    // locking it during the render time, which could hold up the router
+    // threads. The current and best layouts are published and don't change,
+    // so they are rendered directly.
     {
-      Layout layout;
+      LayoutPtr layout;
+      auto current = currentLayout.get();
+      auto best = bestLayout.get();
       if (isComponentDragActive) {
-        layout = inputLayout.threadSafeCopy();
+        layout = std::make_shared<const Layout>(inputLayout.threadSafeCopy());
       }
-      else if (isShowCurrentEnabled && currentLayout.isBasedOn(inputLayout)) {
-        layout = currentLayout.threadSafeCopy();
+      else if (isShowCurrentEnabled && current->isBasedOn(inputLayout)) {
+        layout = current;
       }
-      else if (bestLayout.isBasedOn(inputLayout)) {
-        layout = bestLayout.threadSafeCopy();
+      else if (best->isBasedOn(inputLayout)) {
+        layout = best;
       }
       else {
-        layout = inputLayout.threadSafeCopy();
+        layout = std::make_shared<const Layout>(inputLayout.threadSafeCopy());
       }
 
-      if (!layout.circuit.hasParserError()) {
+      if (!layout->circuit().hasParserError()) {
         // Render the selected layout
         render.draw(
-            layout, projMat, panOffsetScrPos,
+            *layout, projMat, panOffsetScrPos,
             getMouseBoardPos(mousePos(), zoom, panOffsetScrPos), zoom, windowW,
             windowH, isShowRatsNestEnabled || isComponentDragActive,
             isShowOnlyFailedEnabled && !isComponentDragActive);
@@ -546,10 +737,10 @@ class Application : public nanogui::Screen
     // Circuit file errors
     {
       auto lock = inputLayout.scopeLock();
-      if (inputLayout.circuit.hasParserError()) {
+      if (inputLayout.circuit().hasParserError()) {
         int nLine = 0;
         diagText.print(projMat, 0, 0, nLine++, "Circuit file parsing errors:");
-        for (auto s : inputLayout.circuit.parserErrorVec) {
+        for (auto s : inputLayout.circuit().parserErrorVec) {
           diagText.print(projMat, 0, 0, nLine++, s);
         }
       }
@@ -588,9 +779,9 @@ void handleMouseDragOperations(const IntPos& mousePos)
     auto mouseBoardPos = getMouseBoardPos(mousePos, zoom, panOffsetScrPos);
     Via v = (mouseBoardPos - dragPin0BoardOffset + 0.5f).cast<int>();
     auto component =
-        inputLayout.circuit.componentNameToComponentMap[dragComponentName];
+        inputLayout.circuit().componentNameToComponentMap.at(dragComponentName);
     auto footprint =
-        inputLayout.circuit.calcComponentFootprint(dragComponentName);
+        inputLayout.circuit().calcComponentFootprint(dragComponentName);
     auto startPin0Offset = component.pin0AbsPos - footprint.start;
     auto endPin0Offset = footprint.end - component.pin0AbsPos;
     // Left
@@ -602,14 +793,14 @@ void handleMouseDragOperations(const IntPos& mousePos)
       v.y() = startPin0Offset.y();
     }
     // Right
-    if (v.x() + endPin0Offset.x() >= inputLayout.gridW) {
-      v.x() = inputLayout.gridW - endPin0Offset.x() - 1;
+    if (v.x() + endPin0Offset.x() >= inputLayout.gridW()) {
+      v.x() = inputLayout.gridW() - endPin0Offset.x() - 1;
     }
     // Bottom
-    if (v.y() + endPin0Offset.y() >= inputLayout.gridH) {
-      v.y() = inputLayout.gridH - endPin0Offset.y() - 1;
+    if (v.y() + endPin0Offset.y() >= inputLayout.gridH()) {
+      v.y() = inputLayout.gridH() - endPin0Offset.y() - 1;
     }
-    setComponentPosition(inputLayout.circuit, v, dragComponentName);
+    setComponentPosition(inputLayout.editInput().circuit, v, dragComponentName);
     resetInputLayout();
   }
   // Drag board
@@ -634,13 +825,13 @@ void centerBoard()
   if (isZoomPanAdjusted || !inputLayout.isReadyForRouting) {
     return;
   }
-  float zoomW =
-      (windowW - INITIAL_BORDER_PIXELS) / static_cast<float>(inputLayout.gridW);
-  float zoomH =
-      (windowH - INITIAL_BORDER_PIXELS) / static_cast<float>(inputLayout.gridH);
+  float zoomW = (windowW - INITIAL_BORDER_PIXELS)
+                / static_cast<float>(inputLayout.gridW());
+  float zoomH = (windowH - INITIAL_BORDER_PIXELS)
+                / static_cast<float>(inputLayout.gridH());
   zoom = std::min(zoomW, zoomH);
-  float boardScreenW = (inputLayout.gridW - 1) * zoom;
-  float boardScreenH = (inputLayout.gridH - 1) * zoom;
+  float boardScreenW = (inputLayout.gridW() - 1) * zoom;
+  float boardScreenH = (inputLayout.gridH() - 1) * zoom;
   panOffsetScrPos =
       Pos(windowW / 2.0f - boardScreenW / 2.0f,
           windowH / 2.0f - boardScreenH / 2.0f);
@@ -653,55 +844,124 @@ void centerBoard()
 
 void launchRouterThreads()
 {
-  for (int i = 0; i < N_ROUTER_THREADS; ++i) {
-    routerThreadVec[i] = std::thread(routerThread);
+  status.init(nRouterThreads);
+  for (int i = 0; i < nRouterThreads; ++i) {
+    searchStrategyVec.push_back(createSearchStrategy(i));
+  }
+  routerThreadVec.resize(nRouterThreads);
+  for (int i = 0; i < nRouterThreads; ++i) {
+    routerThreadVec[i] = std::thread(routerThread, i);
+  }
+}
+
+// The first random streams are used by the GA islands.
+std::unique_ptr<SearchStrategy> createSearchStrategy(int threadIdx)
+{
+  auto randomStreamIdx = islandModel.getNumIslands() + threadIdx;
+  if (searchStrategyName == "random") {
+    return std::make_unique<RandomSearch>(randomStreamIdx);
+  }
+  if (searchStrategyName == "sa") {
+    return std::make_unique<SimulatedAnnealing>(randomStreamIdx);
   }
+  if (searchStrategyName == "ils") {
+    return std::make_unique<IteratedLocalSearch>(randomStreamIdx);
+  }
+  return std::make_unique<GeneticSearch>(islandModel.getIsland(threadIdx));
 }
 
 void stopRouterThreads()
 {
   threadStopRouter.stop();
-  for (int i = 0; i < N_ROUTER_THREADS; ++i) {
+  routerWorkSignal.notify();
+  for (int i = 0; i < nRouterThreads; ++i) {
     routerThreadVec[i].join();
   }
 }
 
-void routerThread()
+// Pinned router threads get one core each, after the reserved cores. The
+// thread is pinned before allocating its workspace, so that the workspace is
+// on the NUMA node of the core.
+void routerThread(int threadIdx)
 {
-  while (!threadStopRouter.isStopped()) {
+  if (usePinnedThreads) {
+    auto nRouterCores = getNumCores() - nReservedCores;
+    if (!pinCurrentThread(nReservedCores + threadIdx % nRouterCores, 1)
+        && !threadIdx) {
+      fmt::print(stderr, "Unable to pin router threads to cores\n");
+    }
+  }
+  SearchWorkspace searchWorkspace;
+  auto& searchStrategy = *searchStrategyVec[threadIdx];
+  auto& threadStatus = status.getThreadStatus(threadIdx);
+  while (true) {
+    // The epoch is taken before checking for work, so that work which becomes
+    // available after the check ends the wait.
+    auto workEpoch = routerWorkSignal.getEpoch();
+    if (threadStopRouter.isStopped()) {
+      break;
+    }
     Layout threadLayout;
+    unsigned long threadLayoutGeneration;
     {
+      auto lockStart = std::chrono::steady_clock::now();
       auto lock = inputLayout.scopeLock();
-      if (!inputLayout.isReadyForRouting || inputLayout.settings.pause) {
+      threadStatus.addLockWaitTime(
+          std::chrono::steady_clock::now() - lockStart);
+      if (!inputLayout.isReadyForRouting || inputLayout.settings().pause) {
         lock.unlock();
-        std::this_thread::sleep_for(10ms);
+        auto idleStart = std::chrono::steady_clock::now();
+        routerWorkSignal.wait(workEpoch);
+        threadStatus.addIdleTime(std::chrono::steady_clock::now() - idleStart);
         continue;
       }
       threadLayout = inputLayout;
+      threadLayoutGeneration = inputLayoutGeneration.get();
     }
-    int orderingIdx = -1;
+    CancellationToken cancellationToken(
+        threadStopRouter, inputLayoutGeneration, threadLayoutGeneration);
+    // The best ordering from a resumed checkpoint is routed before any
+    // ordering from the search strategy. It is not released to the strategy.
     ConnectionIdxVec connectionIdxVec;
-    if (useRandomSearch) {
-      for (int i = 0;
-           i < static_cast<int>(threadLayout.circuit.connectionVec.size());
-           ++i) {
-        connectionIdxVec.push_back(i);
+    auto isResumeOrdering =
+        takeResumeOrdering(threadLayoutGeneration, connectionIdxVec);
+    int orderingIdx = -1;
+    if (!isResumeOrdering) {
+      orderingIdx = searchStrategy.reserveOrdering();
+      if (orderingIdx == -1) {
+        auto idleStart = std::chrono::steady_clock::now();
+        routerWorkSignal.wait(workEpoch);
+        threadStatus.addIdleTime(std::chrono::steady_clock::now() - idleStart);
+        continue;
       }
-      random_shuffle(connectionIdxVec.begin(), connectionIdxVec.end());
+      connectionIdxVec = searchStrategy.getOrdering(orderingIdx);
     }
-    else {
-      {
-        auto lock = geneticAlgorithm.scopeLock();
-        orderingIdx = geneticAlgorithm.reserveOrdering();
-        if (orderingIdx != -1) {
-          connectionIdxVec = geneticAlgorithm.getOrdering(orderingIdx);
-        }
-      }
-      if (orderingIdx == -1) {
-        std::this_thread::sleep_for(10ms);
+    // An ordering that has already been routed for this input layout gets
+    // its fitness from the cache and is not routed again.
+    CachedFitness fitness;
+    if (!isResumeOrdering && threadLayout.settings().use_fitness_cache
+        && fitnessCache.find(threadLayout, connectionIdxVec, fitness)) {
+      // Ignore the result if the input has changed, as after routing. The
+      // fitness is for the old input layout.
+      if (cancellationToken.isCancelled()) {
         continue;
       }
+      searchStrategy.releaseOrdering(
+          orderingIdx, fitness.nCompletedRoutes, fitness.cost);
+      routerWorkSignal.notify();
+      continue;
+    }
+    // With branch-and-bound, the router stops as soon as the ordering cannot
+    // beat the best layout.
+    RouteBound routeBound;
+    if (!isResumeOrdering && threadLayout.settings().use_route_bound) {
+      auto layout = bestLayout.get();
+      if (layout->isBasedOn(threadLayout)) {
+        routeBound = RouteBound(layout->nCompletedRoutes, layout->cost);
+      }
     }
+    bool isCutOff = false;
+    RouteBound cutOffFitness;
     {
       //  // Testing random costs, to vary how the best path is selected
       //  std::default_random_engine generator;
@@ -709,64 +969,76 @@ void routerThread()
       //  layout_.settings.strip_cost = distribution(generator);
       //  layout_.settings.wire_cost = distribution(generator);
       //  layout_.settings.via_cost = distribution(generator);
+      auto routingStart = std::chrono::steady_clock::now();
+      auto nPrevSearches = searchWorkspace.nSearches;
+      auto nPrevExpandedNodes = searchWorkspace.nExpandedNodes;
       Router router(
-          threadLayout, connectionIdxVec, threadStopRouter, inputLayout,
-          currentLayout, maxRenderDelay);
+          threadLayout, connectionIdxVec, cancellationToken, currentLayout,
+          maxRenderDelay, searchWorkspace, routeBound, routeCache);
       auto isAborted = router.route();
+      threadStatus.addRouting(
+          searchWorkspace.nSearches - nPrevSearches,
+          searchWorkspace.nExpandedNodes - nPrevExpandedNodes,
+          std::chrono::steady_clock::now() - routingStart);
       // Ignore result if the routing was aborted or the input has changed.
-      if (isAborted || !threadLayout.isBasedOn(inputLayout)) {
+      if (isAborted || cancellationToken.isCancelled()) {
         continue;
       }
+      isCutOff = router.isCutOff();
+      cutOffFitness = router.getCutOffFitness();
     }
-    {
-      std::lock_guard<std::mutex> lockStatus(statusMutex);
-      ++status.nCombinationsChecked;
+    threadStatus.addCombinationChecked();
+    // An ordering that was cut off is given the fitness it had reached, with the
+    // remaining routes counted as failed. Its layout is incomplete and cannot
+    // beat the best layout.
+    if (!isResumeOrdering) {
+      if (isCutOff) {
+        searchStrategy.releaseOrdering(
+            orderingIdx, cutOffFitness.nCompletedRoutes, cutOffFitness.cost);
+      }
+      else {
+        searchStrategy.releaseOrdering(
+            orderingIdx, threadLayout.nCompletedRoutes, threadLayout.cost);
+      }
+      routerWorkSignal.notify();
     }
-    if (!useRandomSearch) {
-      auto lock = geneticAlgorithm.scopeLock();
-      geneticAlgorithm.releaseOrdering(
-          orderingIdx, threadLayout.nCompletedRoutes, threadLayout.cost);
+    // The fitness of an ordering that was cut off depends on the best
+    // layout at the time, so only complete results are cached.
+    if (!isCutOff && threadLayout.settings().use_fitness_cache) {
+      fitnessCache.insert(
+          threadLayout, connectionIdxVec,
+          CachedFitness(threadLayout.nCompletedRoutes, threadLayout.cost));
     }
-    // Update currentLayout
-    {
-      auto lock = currentLayout.scopeLock();
-      currentLayout = threadLayout;
-    }
-    // Update bestLayout
-    {
-      auto inputLock = inputLayout.scopeLock();
-      auto bestLock = bestLayout.scopeLock();
-      auto hasMoreCompletedRoutes =
-          threadLayout.nCompletedRoutes > bestLayout.nCompletedRoutes;
-      auto hasEqualRoutesAndBetterScore =
-          threadLayout.nCompletedRoutes == bestLayout.nCompletedRoutes
-          && threadLayout.cost < bestLayout.cost;
-      auto isBasedOnOtherLayout = !bestLayout.isBasedOn(threadLayout);
-      if (hasMoreCompletedRoutes || hasEqualRoutesAndBetterScore
-          || isBasedOnOtherLayout) {
-        bestLayout = threadLayout;
+    // Publish currentLayout and, if it's an improvement, bestLayout
+    if (!isCutOff) {
+      auto layout = std::make_shared<const Layout>(threadLayout);
+      currentLayout.publish(layout);
+      if (bestLayout.publishIfBetter(layout)) {
+        updateBestOrdering(
+            threadLayoutGeneration, connectionIdxVec,
+            threadLayout.nCompletedRoutes, threadLayout.cost);
       }
     }
-    // Print status at interval
+    // Print status at interval. The thread that moves the next checkpoint
+    // prints.
     if (checkpointAtNumChecks != -1) {
-      std::lock_guard<std::mutex> lockStatus(statusMutex);
-      if (!(status.nCombinationsChecked % checkpointAtNumChecks)) {
+      auto nextCheckpoint = nextCheckpointAtNumChecks.load();
+      if (status.getNumCombinationsChecked() >= nextCheckpoint
+          && nextCheckpointAtNumChecks.compare_exchange_strong(
+              nextCheckpoint, nextCheckpoint + checkpointAtNumChecks)) {
         printStats();
       }
     }
     // Automatic app exit on first completed layout
     if (exitOnFirstComplete) {
-      auto bestLock = bestLayout.scopeLock();
-      if (!bestLayout.nFailedRoutes) {
+      if (!bestLayout.get()->nFailedRoutes) {
         exitApp();
       }
     }
     // Automatic app exit after given number of checks
-    if (exitAfterNumChecks != -1) {
-      std::lock_guard<std::mutex> lockStatus(statusMutex);
-      if (status.nCombinationsChecked == exitAfterNumChecks) {
-        exitApp();
-      }
+    if (exitAfterNumChecks != -1
+        && status.getNumCombinationsChecked() >= exitAfterNumChecks) {
+      exitApp();
     }
   }
 }
@@ -783,16 +1055,27 @@ void launchParserThread()
 void stopParserThread()
 {
   threadStopParser.stop();
+  parserWorkSignal.notify();
   parserThreadObj.join();
 }
 
+void unpauseParser()
+{
+  isParserPaused = false;
+  parserWorkSignal.notify();
+}
+
 void parserThread()
 {
   static double prevMtime = 0.0;
   static double curMtime = 0.0;
-  while (!threadStopParser.isStopped()) {
+  while (true) {
+    auto workEpoch = parserWorkSignal.getEpoch();
+    if (threadStopParser.isStopped()) {
+      break;
+    }
     if (isParserPaused) {
-      std::this_thread::sleep_for(100ms);
+      parserWorkSignal.wait(workEpoch);
       continue;
     }
     try {
@@ -801,11 +1084,11 @@ void parserThread()
       {
         auto lock = inputLayout.scopeLock();
         inputLayout = Layout();
-        inputLayout.circuit.parserErrorVec.push_back(errorMsg);
+        inputLayout.editInput().circuit.parserErrorVec.push_back(errorMsg);
         resetInputLayout();
       }
       curMtime = 0.0;
-      std::this_thread::sleep_for(1s);
+      parserWorkSignal.waitFor(workEpoch, 1s);
       continue;
     }
     if (curMtime != prevMtime) {
@@ -813,38 +1096,243 @@ void parserThread()
       Layout threadLayout;
       auto parser = CircuitFileParser(threadLayout);
       parser.parse(circuitFilePath);
+      applyCommandLineSettings(threadLayout.editInput().settings);
       {
         auto lock = inputLayout.scopeLock();
         inputLayout = threadLayout;
         resetInputLayout();
       }
     }
-    std::this_thread::sleep_for(500ms);
+    // There is no portable way to be notified of changes to the .circuit
+    // file, so it is polled. The wait ends early on stop.
+    parserWorkSignal.waitFor(workEpoch, 500ms);
   }
 }
 
+//
+// Search checkpoint thread
+//
+
+void launchCheckpointThread()
+{
+  checkpointThreadObj = std::thread(checkpointThread);
+}
+
+void stopCheckpointThread()
+{
+  threadStopCheckpoint.stop();
+  checkpointWorkSignal.notify();
+  checkpointThreadObj.join();
+}
+
+void checkpointThread()
+{
+  while (true) {
+    auto workEpoch = checkpointWorkSignal.getEpoch();
+    if (threadStopCheckpoint.isStopped()) {
+      break;
+    }
+    checkpointWorkSignal.waitFor(
+        workEpoch, std::chrono::seconds(checkpointIntervalSec));
+    if (threadStopCheckpoint.isStopped()) {
+      break;
+    }
+    saveSearchCheckpoint();
+  }
+}
+
+// The GA islands are locked one at a time while their snapshots are taken, so
+// the router threads are only held up briefly. The checkpoint is dropped if the
+// input layout changed while it was being taken, since the populations and the
+// best ordering may then be for different circuits.
+void saveSearchCheckpoint()
+{
+  SearchCheckpoint checkpoint;
+  unsigned long generation;
+  {
+    auto lock = inputLayout.scopeLock();
+    if (!inputLayout.isReadyForRouting) {
+      return;
+    }
+    checkpoint.circuitHash = calcCircuitHash(inputLayout.circuit());
+    generation = inputLayoutGeneration.get();
+  }
+  checkpoint.randomSeed = getRandomSeed();
+  checkpoint.encodingType = geneEncoding.type;
+  checkpoint.populationVec = islandModel.getSnapshots();
+  {
+    std::lock_guard<std::mutex> lock(bestOrderingMutex);
+    if (bestOrderingGeneration == generation) {
+      checkpoint.bestConnectionIdxVec = bestConnectionIdxVec;
+      checkpoint.bestNCompletedRoutes = bestNCompletedRoutes;
+      checkpoint.bestCost = bestCost;
+    }
+  }
+  if (inputLayoutGeneration.get() != generation) {
+    return;
+  }
+  try {
+    SearchCheckpointFile().write(checkpointFilePath, checkpoint);
+  } catch (const std::runtime_error& e) {
+    fmt::print(stderr, "Unable to save search checkpoint: {}\n", e.what());
+  }
+}
+
+// The best ordering is tracked along with the best layout, so that it can be
+// saved in checkpoints. Two threads can publish better layouts at nearly the
+// same time, so the fitness is compared again here.
+void updateBestOrdering(
+    unsigned long generation, const ConnectionIdxVec& connectionIdxVec,
+    int nCompletedRoutes, long cost)
+{
+  std::lock_guard<std::mutex> lock(bestOrderingMutex);
+  if (generation < bestOrderingGeneration) {
+    return;
+  }
+  if (generation == bestOrderingGeneration && !bestConnectionIdxVec.empty()
+      && (nCompletedRoutes < bestNCompletedRoutes
+          || (nCompletedRoutes == bestNCompletedRoutes && cost >= bestCost))) {
+    return;
+  }
+  bestConnectionIdxVec = connectionIdxVec;
+  bestOrderingGeneration = generation;
+  bestNCompletedRoutes = nCompletedRoutes;
+  bestCost = cost;
+}
+
+bool takeResumeOrdering(
+    unsigned long generation, ConnectionIdxVec& connectionIdxVec)
+{
+  std::lock_guard<std::mutex> lock(bestOrderingMutex);
+  if (resumeConnectionIdxVec.empty()
+      || resumeOrderingGeneration != generation) {
+    return false;
+  }
+  connectionIdxVec.swap(resumeConnectionIdxVec);
+  resumeConnectionIdxVec.clear();
+  return true;
+}
+
+// Apply the checkpoint loaded with --resume to the input layout. The
+// checkpoint is only applied once, and is dropped if it is for a different
+// circuit.
+void resumeSearch()
+{
+  assert(inputLayout.isLocked());
+  auto checkpoint = std::move(resumeCheckpoint);
+  if (checkpoint->circuitHash != calcCircuitHash(inputLayout.circuit())) {
+    fmt::print(
+        stderr,
+        "Search checkpoint is for a different circuit. Starting a new "
+        "search\n");
+    return;
+  }
+  if (!islandModel.restore(checkpoint->populationVec)) {
+    fmt::print(
+        stderr,
+        "Search checkpoint does not match the circuit. Starting a new "
+        "search\n");
+    islandModel.reset(
+        static_cast<int>(inputLayout.circuit().connectionVec.size()),
+        inputLayout.settings().use_steady_state_ga);
+    return;
+  }
+  // The best ordering is only routed again if it is valid for the circuit
+  auto nConnections =
+      static_cast<int>(inputLayout.circuit().connectionVec.size());
+  auto& connectionIdxVec = checkpoint->bestConnectionIdxVec;
+  if (static_cast<int>(connectionIdxVec.size()) == nConnections
+      && std::all_of(
+          connectionIdxVec.begin(), connectionIdxVec.end(),
+          [&](ConnectionIdx i) { return i >= 0 && i < nConnections; })) {
+    std::lock_guard<std::mutex> lock(bestOrderingMutex);
+    resumeConnectionIdxVec = connectionIdxVec;
+    resumeOrderingGeneration = inputLayoutGeneration.get();
+  }
+  fmt::print(
+      "Resumed search from {}. Best: nCompletedRoutes={:n} cost={:n}\n",
+      checkpointFilePath, checkpoint->bestNCompletedRoutes,
+      checkpoint->bestCost);
+}
+
 void resetInputLayout()
 {
   assert(inputLayout.isLocked());
   inputLayout.updateBaseTimestamp();
-  status.nCombinationsChecked = 0;
+  inputLayoutGeneration.advance();
+  status.reset();
+  nextCheckpointAtNumChecks = checkpointAtNumChecks;
   guiStatus.reset();
-  {
-    auto lock = geneticAlgorithm.scopeLock();
-    geneticAlgorithm.reset(
-        static_cast<int>(inputLayout.circuit.connectionVec.size()));
+  // Keep evolving the existing population if any of the connections are the
+  // same as before, which is the case when components are moved or settings
+  // are changed.
+  auto& connectionVec = inputLayout.circuit().connectionVec;
+  auto prevConnectionIdxVec =
+      calcPrevConnectionIdxVec(gaConnectionVec, connectionVec);
+  gaConnectionVec = connectionVec;
+  auto isWarmStart = std::any_of(
+      prevConnectionIdxVec.begin(), prevConnectionIdxVec.end(),
+      [](ConnectionIdx i) { return i != -1; });
+  if (isWarmStart) {
+    islandModel.warmStart(
+        prevConnectionIdxVec, inputLayout.settings().use_steady_state_ga);
+  }
+  else {
+    islandModel.reset(
+        static_cast<int>(connectionVec.size()),
+        inputLayout.settings().use_steady_state_ga);
+  }
+  for (auto& searchStrategy : searchStrategyVec) {
+    searchStrategy->reset(static_cast<int>(connectionVec.size()));
+  }
+  if (resumeCheckpoint && inputLayout.isReadyForRouting) {
+    resumeSearch();
   }
+  routerWorkSignal.notify();
+}
+
+// Return the index of each connection in the previous connections, or -1 if
+// the connection is new. Connections are identified by their end points.
+ConnectionIdxVec calcPrevConnectionIdxVec(
+    const ConnectionVec& prevConnectionVec, const ConnectionVec& connectionVec)
+{
+  typedef std::tuple<std::string, int, std::string, int> ConnectionKey;
+  auto getKey = [](const Connection& c) {
+    return ConnectionKey(
+        c.start.componentName, c.start.pinIdx, c.end.componentName,
+        c.end.pinIdx);
+  };
+  std::multimap<ConnectionKey, ConnectionIdx> prevKeyToIdxMap;
+  for (int i = 0; i < static_cast<int>(prevConnectionVec.size()); ++i) {
+    prevKeyToIdxMap.insert(std::make_pair(getKey(prevConnectionVec[i]), i));
+  }
+  ConnectionIdxVec prevConnectionIdxVec;
+  for (auto& connection : connectionVec) {
+    auto key = getKey(connection);
+    auto itr = prevKeyToIdxMap.lower_bound(key);
+    if (itr == prevKeyToIdxMap.end() || itr->first != key) {
+      prevConnectionIdxVec.push_back(-1);
+    }
+    else {
+      prevConnectionIdxVec.push_back(itr->second);
+      prevKeyToIdxMap.erase(itr);
+    }
+  }
+  return prevConnectionIdxVec;
 }
 
 int main(int argc, char** argv)
 {
   //  fmt::print("GLFW: {}\n", glfwGetVersionString());
-  std::srand(std::time(0));
 
   parseCommandLineArgs(argc, argv);
 
+  pinMainThread();
   launchRouterThreads();
   launchParserThread();
+  if (checkpointIntervalSec) {
+    launchCheckpointThread();
+  }
 
   try {
     if (noGui) {
@@ -864,6 +1352,12 @@ int main(int argc, char** argv)
 
   stopParserThread();
   stopRouterThreads();
+  // The final checkpoint is saved after the router threads have stopped, so it
+  // holds all of the search.
+  if (checkpointIntervalSec) {
+    stopCheckpointThread();
+    saveSearchCheckpoint();
+  }
 
   if (noGui || exitOnFirstComplete || exitAfterNumChecks != -1) {
     printStats();
@@ -878,7 +1372,11 @@ void parseCommandLineArgs(int argc, char** argv)
 
   parser.set_optional<bool>("n", "nogui", false, "Do not open the GUI window");
   parser.set_optional<bool>(
-      "r", "random", false, "Use random search instead of genetic algorithm");
+      "r", "random", false, "Use random search (same as --strategy random)");
+  parser.set_optional<std::string>(
+      "j", "strategy", "ga",
+      "Search strategy: ga, random, sa (simulated annealing) or ils (iterated "
+      "local search)");
   parser.set_optional<bool>(
       "e", "exitcomplete", false,
       "Print stats and exit when first complete layout is found");
@@ -886,30 +1384,219 @@ void parseCommandLineArgs(int argc, char** argv)
       "a", "exitafter", -1,
       "Print stats and exit after specified number of checks");
   parser.set_optional<long>("p", "checkpoint", -1, "Print stats at interval");
+  parser.set_optional<long>(
+      "x", "seed", -1,
+      "Seed for the random number generators (default: seed from clock)");
   parser.set_optional<std::string>(
       "c", "circuit", CIRCUIT_FILE_PATH, "Path to .circuit file");
+  parser.set_optional<bool>(
+      "s", "astar", false, "Use A* instead of uniform cost search for routes");
+  parser.set_optional<bool>(
+      "b", "bucketqueue", false,
+      "Use a bucket queue instead of a binary heap for route search");
+  parser.set_optional<bool>(
+      "u", "runedges", false,
+      "Expand whole strips and wires as single steps in route search");
+  parser.set_optional<bool>(
+      "i", "bidirectional", false, "Search for routes from both ends at once");
+  parser.set_optional<bool>(
+      "d", "bound", false,
+      "Stop routing an ordering when it cannot beat the best layout");
+  parser.set_optional<bool>(
+      "m", "routecache", false,
+      "Resume routing from cached states for shared ordering prefixes");
+  parser.set_optional<bool>(
+      "f", "fitnesscache", false,
+      "Reuse the fitness of orderings that have already been routed");
+  parser.set_optional<long>(
+      "z", "fitnesscachemb", DEFAULT_FITNESS_CACHE_MB,
+      "Memory limit for the fitness cache, in MB");
+  parser.set_optional<long>(
+      "l", "islands", 1,
+      "Number of GA islands, up to one per router thread (1 = no islands)");
+  parser.set_optional<long>(
+      "v", "migrationinterval", DEFAULT_MIGRATION_INTERVAL,
+      "Generations between migrations between GA islands");
+  parser.set_optional<long>(
+      "k", "migrants", DEFAULT_N_MIGRANTS,
+      "Number of organisms sent in each migration between GA islands");
+  parser.set_optional<std::string>(
+      "o", "encoding", "dependency",
+      "GA genome encoding: dependency or permutation");
+  parser.set_optional<std::string>(
+      "q", "crossover", "ox",
+      "Crossover for the permutation encoding: ox, pmx or erx");
+  parser.set_optional<std::string>(
+      "w", "mutation", "swap",
+      "Mutation for the permutation encoding: swap, insert or inversion");
+  parser.set_optional<long>(
+      "t", "threads", 0,
+      "Number of router threads (default: one per core not reserved for the "
+      "GUI)");
+  parser.set_optional<bool>(
+      "P", "pin", false, "Pin each router thread to its own core");
+  parser.set_optional<long>(
+      "G", "guicores", 0,
+      "Number of cores reserved for the GUI and parser threads");
+  parser.set_optional<bool>(
+      "g", "steadystate", false,
+      "Use a steady-state GA instead of a generational GA");
+  parser.set_optional<long>(
+      "I", "saveinterval", 0,
+      "Save a search checkpoint at interval, in seconds (0 = no checkpoints)");
+  parser.set_optional<std::string>(
+      "S", "statefile", "",
+      "Path to search checkpoint file (default: .circuit file path + "
+      "\".search\")");
+  parser.set_optional<bool>(
+      "y", "resume", false, "Resume the search from the checkpoint file");
   // parser.set_required<std::vector<short>>("v", "values", "By using a vector
   // it is possible to receive a multitude of inputs.");
 
   parser.run_and_exit_if_error();
 
   noGui = parser.get<bool>("n");
-  useRandomSearch = parser.get<bool>("r");
+  searchStrategyName = parser.get<std::string>("j");
+  if (parser.get<bool>("r")) {
+    searchStrategyName = "random";
+  }
+  if (searchStrategyName != "ga" && searchStrategyName != "random"
+      && searchStrategyName != "sa" && searchStrategyName != "ils") {
+    fmt::print(stderr, "Invalid search strategy: {}\n", searchStrategyName);
+    exit(EXIT_FAILURE);
+  }
   exitOnFirstComplete = parser.get<bool>("e");
   exitAfterNumChecks = parser.get<long>("a");
   checkpointAtNumChecks = parser.get<long>("p");
+  auto seed = parser.get<long>("x");
+  if (seed != -1) {
+    setRandomSeed(static_cast<std::uint64_t>(seed));
+  }
   circuitFilePath = parser.get<std::string>("c");
+  useAStar = parser.get<bool>("s");
+  useBucketQueue = parser.get<bool>("b");
+  useRunEdges = parser.get<bool>("u");
+  useBidirectional = parser.get<bool>("i");
+  useRouteBound = parser.get<bool>("d");
+  useRouteCache = parser.get<bool>("m");
+  useFitnessCache = parser.get<bool>("f");
+  fitnessCache.setMaxBytes(
+      static_cast<size_t>(parser.get<long>("z")) * 1024 * 1024);
+  useSteadyStateGa = parser.get<bool>("g");
+  nReservedCores = clamp(
+      static_cast<int>(parser.get<long>("G")), 0, getNumCores() - 1);
+  usePinnedThreads = parser.get<bool>("P");
+  nRouterThreads = static_cast<int>(parser.get<long>("t"));
+  if (nRouterThreads <= 0) {
+#ifndef NDEBUG
+    nRouterThreads = 1;
+#else
+    nRouterThreads = getNumCores() - nReservedCores;
+#endif
+  }
+  auto nIslands = static_cast<int>(parser.get<long>("l"));
+  geneEncoding = parseGeneEncoding(
+      parser.get<std::string>("o"), parser.get<std::string>("q"),
+      parser.get<std::string>("w"));
+  checkpointIntervalSec = std::max(0L, parser.get<long>("I"));
+  checkpointFilePath = parser.get<std::string>("S");
+  if (checkpointFilePath.empty()) {
+    checkpointFilePath = circuitFilePath + ".search";
+  }
+  if (parser.get<bool>("y")) {
+    loadResumeCheckpoint(seed != -1);
+  }
+  islandModel.init(
+      std::max(1, std::min(nRouterThreads, nIslands)),
+      std::max(1, static_cast<int>(parser.get<long>("v"))),
+      std::max(0, static_cast<int>(parser.get<long>("k"))), geneEncoding);
   // auto values = parser.get<std::vector<short>>("v");
 }
 
-void runHeadless()
+// The checkpoint's seed is used unless another seed was given, so that new
+// random streams continue from the same seed as the resumed search.
+void loadResumeCheckpoint(bool isSeedSet)
 {
-  isParserPaused = false;
-  while (!threadStopApp.isStopped()) {
-    std::this_thread::sleep_for(100ms);
+  try {
+    resumeCheckpoint = std::make_unique<SearchCheckpoint>(
+        SearchCheckpointFile().read(checkpointFilePath));
+  } catch (const std::runtime_error& e) {
+    fmt::print(stderr, "Unable to resume search: {}\n", e.what());
+    exit(EXIT_FAILURE);
+  }
+  if (resumeCheckpoint->encodingType != geneEncoding.type) {
+    fmt::print(
+        stderr,
+        "Unable to resume search: The checkpoint is for another GA encoding\n");
+    exit(EXIT_FAILURE);
+  }
+  if (!isSeedSet) {
+    setRandomSeed(resumeCheckpoint->randomSeed);
   }
 }
 
+GeneEncoding parseGeneEncoding(
+    const std::string& encodingStr, const std::string& crossoverStr,
+    const std::string& mutationStr)
+{
+  const std::map<std::string, EncodingType> typeMap = {
+    { "dependency", EncodingType::Dependency },
+    { "permutation", EncodingType::Permutation },
+  };
+  const std::map<std::string, PermutationCrossover> crossoverMap = {
+    { "ox", PermutationCrossover::Order },
+    { "pmx", PermutationCrossover::PartiallyMapped },
+    { "erx", PermutationCrossover::EdgeRecombination },
+  };
+  const std::map<std::string, PermutationMutation> mutationMap = {
+    { "swap", PermutationMutation::Swap },
+    { "insert", PermutationMutation::Insert },
+    { "inversion", PermutationMutation::Inversion },
+  };
+  if (!typeMap.count(encodingStr) || !crossoverMap.count(crossoverStr)
+      || !mutationMap.count(mutationStr)) {
+    fmt::print(
+        stderr, "Invalid GA encoding, crossover or mutation: {} {} {}\n",
+        encodingStr, crossoverStr, mutationStr);
+    exit(EXIT_FAILURE);
+  }
+  GeneEncoding encoding;
+  encoding.type = typeMap.at(encodingStr);
+  encoding.crossover = crossoverMap.at(crossoverStr);
+  encoding.mutation = mutationMap.at(mutationStr);
+  return encoding;
+}
+
+// The GUI thread is pinned to the reserved cores, so that the router threads
+// do not slow down the GUI. The parser thread inherits the affinity.
+void pinMainThread()
+{
+  if (usePinnedThreads && nReservedCores) {
+    pinCurrentThread(0, nReservedCores);
+  }
+}
+
+// Settings that can be given on the command line are applied to each new
+// input layout, since the layout starts out with default settings each time the
+// .circuit file is parsed.
+void applyCommandLineSettings(Settings& settings)
+{
+  settings.use_astar = useAStar;
+  settings.use_bucket_queue = useBucketQueue;
+  settings.use_run_edges = useRunEdges;
+  settings.use_bidirectional = useBidirectional;
+  settings.use_route_bound = useRouteBound;
+  settings.use_route_cache = useRouteCache;
+  settings.use_fitness_cache = useFitnessCache;
+  settings.use_steady_state_ga = useSteadyStateGa;
+}
+
+void runHeadless()
+{
+  unpauseParser();
+  threadStopApp.wait();
+}
+
 void runGui()
 {
   nanogui::init();
@@ -917,7 +1604,7 @@ void runGui()
   nanogui::ref<Application> app = new Application();
   app->setVisible(true);
   setWindowIcon("./icons/48x48.png");
-  isParserPaused = false;
+  unpauseParser();
 
   nanogui::mainloop();
 
@@ -926,19 +1613,61 @@ void runGui()
   nanogui::shutdown();
 }
 
+// May be called by several router threads at once.
 void exitApp()
 {
+  if (isAppExiting.exchange(true)) {
+    return;
+  }
   nanogui::leave();
   threadStopApp.stop();
 }
 
 void printStats()
 {
+  auto layout = bestLayout.get();
   auto inputLock = inputLayout.scopeLock();
-  auto bestLock = bestLayout.scopeLock();
+  auto totalCounts = status.getTotalCounts();
   fmt::print(
       "search={} nChecks={:n} Best: nCompletedRoutes={:n} nFailedRoutes={:n} "
       "cost={:n}\n",
-      useRandomSearch ? "random" : "GA", status.nCombinationsChecked,
-      bestLayout.nCompletedRoutes, bestLayout.nFailedRoutes, bestLayout.cost);
+      searchStrategyName, totalCounts.nCombinationsChecked,
+      layout->nCompletedRoutes, layout->nFailedRoutes, layout->cost);
+  if (inputLayout.settings().use_route_cache) {
+    auto stats = routeCache.getStats();
+    fmt::print(
+        "Route cache: hitRate={:.1f}% reusedRoutes={:n} entries={:n} "
+        "memory={:n}KB\n",
+        stats.nLookups ? 100.0 * stats.nHits / stats.nLookups : 0.0,
+        stats.nReusedRoutes, stats.nEntries, stats.memoryBytes / 1024);
+  }
+  if (inputLayout.settings().use_fitness_cache) {
+    auto stats = fitnessCache.getStats();
+    fmt::print(
+        "Fitness cache: hits={:n} misses={:n} entries={:n} memory={:n}KB\n",
+        stats.nHits, stats.nMisses, stats.nEntries, stats.memoryBytes / 1024);
+  }
+  // Routing efficiency is the share of the thread time spent routing, so it
+  // shows how well the search scales with the number of threads. The rates
+  // are not available just after a reset.
+  auto elapsedSec = status.getElapsedSec();
+  if (elapsedSec <= 0) {
+    return;
+  }
+  auto toSec = [](std::chrono::nanoseconds t) { return t.count() / 1e9; };
+  fmt::print(
+      "Threads: n={} routingEfficiency={:.1f}% idle={:.2f}s lockWait={:.2f}s\n",
+      status.getNumThreads(),
+      100.0 * toSec(totalCounts.routingTime)
+          / (elapsedSec * status.getNumThreads()),
+      toSec(totalCounts.idleTime), toSec(totalCounts.lockWaitTime));
+  for (int i = 0; i < status.getNumThreads(); ++i) {
+    auto counts = status.getThreadCounts(i);
+    fmt::print(
+        "Thread {}: checks/s={:.2f} routes/s={:.1f} expandedNodes/s={:.0f} "
+        "idle={:.2f}s lockWait={:.3f}s\n",
+        i, counts.nCombinationsChecked / elapsedSec,
+        counts.nRoutes / elapsedSec, counts.nExpandedNodes / elapsedSec,
+        toSec(counts.idleTime), toSec(counts.lockWaitTime));
+  }
 }
@@ -0,0 +1,31 @@
+#include "migration_channel.h"
+
+MigrationBatch::MigrationBatch() : migrationEpoch(0)
+{
+}
+
+MigrationChannel::MigrationChannel() : head_(0), tail_(0)
+{
+}
+
+bool MigrationChannel::push(MigrationBatch&& batch)
+{
+  auto tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == CAPACITY) {
+    return false;
+  }
+  batchArr_[tail % CAPACITY] = std::move(batch);
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+bool MigrationChannel::pop(MigrationBatch& batch)
+{
+  auto head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  batch = std::move(batchArr_[head % CAPACITY]);
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+
+#include "ga_core.h"
+
+// Organisms sent from one island to the next in the island model GA.
+class MigrationBatch
+{
+  public:
+  MigrationBatch();
+  // Migrants are only accepted by islands in the same migration epoch as the
+  // island that sent them. The epoch is set for all islands by the
+  // IslandModel each time they are reset, so it is the same for islands that
+  // evolve populations for the same input layout.
+  int migrationEpoch;
+  OrganismVec organismVec;
+};
+
+// Lock-free single producer, single consumer queue of migration batches. The
+// producer and consumer are the islands on either side of the channel, and
+// each island is only accessed while its lock is held, so there is never more
+// than one producer or consumer at a time. If the queue is full, new batches
+// are dropped.
+class MigrationChannel
+{
+  public:
+  MigrationChannel();
+  bool push(MigrationBatch&& batch);
+  bool pop(MigrationBatch& batch);
+
+  private:
+  static const int CAPACITY = 4;
+  MigrationBatch batchArr_[CAPACITY];
+  // Written only by the consumer
+  std::atomic<unsigned> head_;
+  // Written only by the producer
+  std::atomic<unsigned> tail_;
+};
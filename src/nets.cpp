@@ -1,47 +1,33 @@
+#include <utility>
+
 #include "nets.h"
 
 Nets::Nets(Layout& _layout)
   : layout_(_layout),
-    setIdxVec_(_layout.setIdxVec),
-    viaSetVec_(_layout.viaSetVec)
+    parentIdxVec_(_layout.netParentIdxVec),
+    rankVec_(_layout.netRankVec)
 {
-  setIdxVec_ = SetIdxVec(layout_.gridW * layout_.gridH, -1);
+  parentIdxVec_ = SetIdxVec(layout_.gridW() * layout_.gridH(), -1);
+  rankVec_ = NetRankVec(layout_.gridW() * layout_.gridH(), 0);
 }
 
 void Nets::connect(const Via& viaA, const Via& viaB)
 {
-  int setIdxA = getViaSetIdx(viaA);
-  int setIdxB = getViaSetIdx(viaB);
   // TODO: These asserts get triggered by a fast component drag out of the board on the top side.
-  assert(setIdxA < static_cast<int>(viaSetVec_.size()));
-  assert(setIdxB < static_cast<int>(viaSetVec_.size()));
+  assert(layout_.idx(viaA) < static_cast<int>(parentIdxVec_.size()));
+  assert(layout_.idx(viaB) < static_cast<int>(parentIdxVec_.size()));
 
-  if (setIdxA == -1 && setIdxB == -1) {
-    auto viaSetIdx = createViaSet();
-    viaSetVec_[viaSetIdx].insert(viaA);
-    viaSetVec_[viaSetIdx].insert(viaB);
-    setIdxVec_[layout_.idx(viaA)] = viaSetIdx;
-    setIdxVec_[layout_.idx(viaB)] = viaSetIdx;
-  }
-  else if (setIdxA != -1 && setIdxB == -1) {
-    auto& viaSet = viaSetVec_[setIdxA];
-    viaSet.insert(viaB);
-    setIdxVec_[layout_.idx(viaB)] = setIdxA;
+  int rootA = addToNet(layout_.idx(viaA));
+  int rootB = addToNet(layout_.idx(viaB));
+  if (rootA == rootB) {
+    return;
   }
-  else if (setIdxA == -1 && setIdxB != -1) {
-    auto& viaSet = viaSetVec_[setIdxB];
-    viaSet.insert(viaA);
-    setIdxVec_[layout_.idx(viaA)] = setIdxB;
+  if (rankVec_[rootA] < rankVec_[rootB]) {
+    std::swap(rootA, rootB);
   }
-  else {
-    auto& viaSetA = viaSetVec_[setIdxA];
-    auto& viaSetB = viaSetVec_[setIdxB];
-    viaSetA.insert(viaSetB.begin(), viaSetB.end());
-    for (auto& v : setIdxVec_) {
-      if (v == setIdxB) {
-        v = setIdxA;
-      }
-    }
+  parentIdxVec_[rootB] = rootA;
+  if (rankVec_[rootA] == rankVec_[rootB]) {
+    ++rankVec_[rootA];
   }
 }
 
@@ -64,54 +50,84 @@ void Nets::connectRoute(const RouteStepVec& routeStepVec)
 // for equivalents.
 void Nets::registerPin(const Via& via)
 {
-  int setIdx = getViaSetIdx(via);
-  if (setIdx != -1) {
-    auto& viaSet = viaSetVec_[setIdx];
-    viaSet.insert(via);
-  }
-  else {
-    auto viaSetIdx = createViaSet();
-    viaSetVec_[viaSetIdx].insert(via);
-    setIdxVec_[layout_.idx(via)] = viaSetIdx;
-  }
+  addToNet(layout_.idx(via));
 }
 
 bool Nets::isConnected(const Via& currentVia, const Via& targetVia)
 {
-  auto viaSetIdx = setIdxVec_[layout_.idx(currentVia)];
-  if (viaSetIdx == -1) {
+  int currentIdx = layout_.idx(currentVia);
+  int targetIdx = layout_.idx(targetVia);
+  if (parentIdxVec_[currentIdx] == -1 || parentIdxVec_[targetIdx] == -1) {
     return false;
   }
-  bool r = static_cast<bool>(viaSetVec_[viaSetIdx].count(targetVia));
-  return r;
+  return findRoot(currentIdx) == findRoot(targetIdx);
 }
 
 bool Nets::hasConnection(const Via& via)
 {
-  auto viaSetIdx = setIdxVec_[layout_.idx(via)];
-  return viaSetIdx != -1;
+  return parentIdxVec_[layout_.idx(via)] != -1;
 }
 
-ViaSet& Nets::getViaSet(const Via& via)
+//
+// Private
+//
+
+// Return the root of the net of the via, creating a net with only the via if
+// it is not in one already.
+int Nets::addToNet(int idx)
 {
-  int traceIdx = layout_.idx(via);
-  int setIdx = setIdxVec_[traceIdx];
-  assert(setIdx != -1);
-  return viaSetVec_[setIdx];
+  if (parentIdxVec_[idx] == -1) {
+    parentIdxVec_[idx] = idx;
+    return idx;
+  }
+  return findRoot(idx);
+}
+
+int Nets::findRoot(int idx)
+{
+  int rootIdx = idx;
+  while (parentIdxVec_[rootIdx] != rootIdx) {
+    rootIdx = parentIdxVec_[rootIdx];
+  }
+  while (parentIdxVec_[idx] != rootIdx) {
+    int parentIdx = parentIdxVec_[idx];
+    parentIdxVec_[idx] = rootIdx;
+    idx = parentIdx;
+  }
+  return rootIdx;
 }
 
 //
-// Private
+// Read only access
 //
 
-int Nets::createViaSet()
+int findNetRoot(const Layout& layout, int idx)
 {
-  viaSetVec_.push_back(ViaSet());
-  return static_cast<int>(viaSetVec_.size()) - 1;
+  const auto& parentIdxVec = layout.netParentIdxVec;
+  if (idx >= static_cast<int>(parentIdxVec.size())
+      || parentIdxVec[idx] == -1) {
+    return -1;
+  }
+  while (parentIdxVec[idx] != idx) {
+    idx = parentIdxVec[idx];
+  }
+  return idx;
 }
 
-int Nets::getViaSetIdx(const Via& via)
+ViaSet getNetViaSet(const Layout& layout, const Via& via)
 {
-  int traceIdx = layout_.idx(via);
-  return setIdxVec_[traceIdx];
+  ViaSet viaSet;
+  int rootIdx = findNetRoot(layout, layout.idx(via));
+  if (rootIdx == -1) {
+    return viaSet;
+  }
+  for (int y = 0; y < layout.gridH(); ++y) {
+    for (int x = 0; x < layout.gridW(); ++x) {
+      Via v(x, y);
+      if (findNetRoot(layout, layout.idx(v)) == rootIdx) {
+        viaSet.insert(v);
+      }
+    }
+  }
+  return viaSet;
 }
@@ -14,6 +14,12 @@
 // The nets are also what allows creating multiple routes from a single pin or
 // to a single pin. Without the nets, the first route connected to a pin would
 // block the pin off for other routes.
+//
+// The nets are stored in the Layout as a disjoint-set forest over the via
+// indexes, with path compression and union by rank, so connect() and
+// isConnected() are close to O(1). Vias that are not in any net have no parent.
+// The members of a net are not stored, but can be enumerated with getNetViaSet()
+// when needed, e.g., for highlighting a net in the GUI.
 
 class Nets
 {
@@ -24,12 +30,17 @@ class Nets
   void registerPin(const Via& via);
   bool isConnected(const Via& currentVia, const Via& targetVia);
   bool hasConnection(const Via& via);
-  ViaSet& getViaSet(const Via& via);
-  int getViaSetIdx(const Via& via);
 
   private:
-  int createViaSet();
+  int addToNet(int idx);
+  int findRoot(int idx);
   Layout& layout_;
-  SetIdxVec& setIdxVec_;
-  ViaSetVec& viaSetVec_;
+  SetIdxVec& parentIdxVec_;
+  NetRankVec& rankVec_;
 };
+
+// Find the root of the net of a via without modifying the Layout. Return -1
+// if the via is not in a net.
+int findNetRoot(const Layout& layout, int idx);
+// All the vias in the net of a via. This scans the whole grid.
+ViaSet getNetViaSet(const Layout& layout, const Via& via);
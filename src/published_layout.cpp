@@ -0,0 +1,55 @@
+#include "published_layout.h"
+
+PublishedLayout::PublishedLayout() : layout_(std::make_shared<const Layout>())
+{
+}
+
+LayoutPtr PublishedLayout::get() const
+{
+  return std::atomic_load(&layout_);
+}
+
+void PublishedLayout::publish(LayoutPtr layout)
+{
+  std::atomic_store(&layout_, std::move(layout));
+}
+
+// Publish the layout if it is better than the published layout. If another
+// thread publishes a layout in the meantime, the layout is compared again with
+// that one. Return true if the layout was published.
+bool PublishedLayout::publishIfBetter(LayoutPtr layout)
+{
+  auto publishedLayout = std::atomic_load(&layout_);
+  while (isBetter(*layout, *publishedLayout)) {
+    if (std::atomic_compare_exchange_weak(&layout_, &publishedLayout, layout)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//
+// Private
+//
+
+// The empty layout that is published initially is replaced by any routed
+// layout. After that, a layout that is based on a newer input layout is always
+// better, and a layout that is based on an older input layout is never better.
+// That way, a router thread that finishes a layout for an old input layout
+// cannot replace a layout for the current input layout.
+bool PublishedLayout::isBetter(
+    const Layout& layout, const Layout& publishedLayout)
+{
+  if (!publishedLayout.isReadyForEval) {
+    return true;
+  }
+  if (!layout.isBasedOn(publishedLayout)) {
+    return layout.getBaseTimestamp() > publishedLayout.getBaseTimestamp();
+  }
+  auto hasMoreCompletedRoutes =
+      layout.nCompletedRoutes > publishedLayout.nCompletedRoutes;
+  auto hasEqualRoutesAndBetterScore =
+      layout.nCompletedRoutes == publishedLayout.nCompletedRoutes
+      && layout.cost < publishedLayout.cost;
+  return hasMoreCompletedRoutes || hasEqualRoutesAndBetterScore;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+
+#include "layout.h"
+
+// A layout that the router threads publish for the GUI and for each other,
+// such as the current and best layouts. A published layout is immutable. A
+// writer publishes a new layout by atomically swapping in a pointer to it, and
+// a reader gets a pointer to the layout that was published at the time. The
+// reader can keep using the layout for as long as it needs, and the layout is
+// freed when the last reader lets go of it. Neither readers nor writers take
+// the input layout lock or copy the layout while publishing or reading.
+// std::atomic_load() and std::atomic_store() on shared_ptr are not lock-free
+// in libstdc++ or MSVC, but only hold a short internal lock around the pointer
+// swap.
+
+typedef std::shared_ptr<const Layout> LayoutPtr;
+
+class PublishedLayout
+{
+  public:
+  PublishedLayout();
+  LayoutPtr get() const;
+  void publish(LayoutPtr layout);
+  bool publishIfBetter(LayoutPtr layout);
+
+  private:
+  bool isBetter(const Layout& layout, const Layout& publishedLayout);
+  LayoutPtr layout_;
+};
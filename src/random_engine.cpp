@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+
+#include "random_engine.h"
+
+std::atomic<std::uint64_t> randomSeed(static_cast<std::uint64_t>(
+    std::chrono::system_clock::now().time_since_epoch().count()));
+
+std::uint64_t splitMix64(std::uint64_t& x)
+{
+  std::uint64_t z = (x += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+std::uint64_t rotl(std::uint64_t x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+// The seed is used by streams created after the call.
+void setRandomSeed(std::uint64_t seed)
+{
+  randomSeed = seed;
+}
+
+std::uint64_t getRandomSeed()
+{
+  return randomSeed;
+}
+
+//
+// RandomEngine
+//
+
+RandomEngine::RandomEngine(std::uint64_t seed, int streamIdx)
+{
+  assert(streamIdx >= 0);
+  for (auto& s : s_) {
+    s = splitMix64(seed);
+  }
+  for (int i = 0; i < streamIdx; ++i) {
+    jump();
+  }
+}
+
+RandomEngine::result_type RandomEngine::operator()()
+{
+  std::uint64_t result = rotl(s_[1] * 5, 7) * 9;
+  std::uint64_t t = s_[1] << 17;
+  s_[2] ^= s_[0];
+  s_[3] ^= s_[1];
+  s_[1] ^= s_[2];
+  s_[0] ^= s_[3];
+  s_[2] ^= t;
+  s_[3] = rotl(s_[3], 45);
+  return result;
+}
+
+// Uniform in [min, max]. The modulo bias is negligible for the small ranges
+// used here. Unlike std::uniform_int_distribution, this gives the same
+// sequence with all standard libraries.
+int RandomEngine::getRandomInt(int min, int max)
+{
+  assert(min <= max);
+  std::uint64_t range = static_cast<std::uint64_t>(max - min) + 1;
+  return min + static_cast<int>((*this)() % range);
+}
+
+// Uniform in [0, 1)
+double RandomEngine::getNormalizedRandom()
+{
+  return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Fisher-Yates shuffle. std::shuffle() draws through
+// std::uniform_int_distribution, so it would not give the same order with all
+// standard libraries.
+void RandomEngine::shuffle(std::vector<int>& v)
+{
+  for (int i = static_cast<int>(v.size()) - 1; i > 0; --i) {
+    std::swap(v[i], v[getRandomInt(0, i)]);
+  }
+}
+
+RandomEngineState RandomEngine::getState() const
+{
+  return { s_[0], s_[1], s_[2], s_[3] };
+}
+
+void RandomEngine::setState(const RandomEngineState& state)
+{
+  std::copy(state.begin(), state.end(), s_);
+}
+
+//
+// Private
+//
+
+// Equivalent to 2^128 calls to operator()
+void RandomEngine::jump()
+{
+  static const std::uint64_t JUMP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+                                        0xa9582618e03fc9aa,
+                                        0x39abdc4529b1661c };
+  std::uint64_t s[] = { 0, 0, 0, 0 };
+  for (auto jump : JUMP) {
+    for (int b = 0; b < 64; ++b) {
+      if (jump & std::uint64_t(1) << b) {
+        for (int i = 0; i < 4; ++i) {
+          s[i] ^= s_[i];
+        }
+      }
+      (*this)();
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    s_[i] = s[i];
+  }
+}
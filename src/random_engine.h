@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// All randomness in the GA and router threads comes from RandomEngine streams
+// derived from a single seed, so that runs can be repeated with --seed. Each
+// thread, or other independent user, creates its own stream by passing a
+// unique stream index, so no locking is needed and the streams don't depend
+// on the order in which the threads happen to run.
+//
+// The generator is xoshiro256** (Blackman and Vigna). The state is seeded with
+// splitmix64, and stream n starts n jumps of 2^128 steps into the sequence, so
+// the streams do not overlap.
+
+void setRandomSeed(std::uint64_t seed);
+std::uint64_t getRandomSeed();
+
+typedef std::array<std::uint64_t, 4> RandomEngineState;
+
+class RandomEngine
+{
+  public:
+  typedef std::uint64_t result_type;
+  RandomEngine(std::uint64_t seed, int streamIdx);
+  static constexpr result_type min()
+  {
+    return 0;
+  }
+  static constexpr result_type max()
+  {
+    return UINT64_MAX;
+  }
+  result_type operator()();
+  int getRandomInt(int min, int max);
+  double getNormalizedRandom();
+  void shuffle(std::vector<int>& v);
+  // For checkpoints
+  RandomEngineState getState() const;
+  void setState(const RandomEngineState& state);
+
+  private:
+  void jump();
+
+  std::uint64_t s_[4];
+};
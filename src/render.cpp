@@ -11,6 +11,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "gui.h"
+#include "nets.h"
 #include "render.h"
 #include "shader.h"
 
@@ -52,7 +53,7 @@ void Render::openGLFree()
 }
 
 void Render::draw(
-    Layout& layout, glm::mat4x4& projMat, const Pos& boardScreenOffset,
+    const Layout& layout, glm::mat4x4& projMat, const Pos& boardScreenOffset,
     const Pos& mouseBoardPos, float zoom, int windowW, int windowH,
     bool showRatsNestBool, bool showOnlyFailedBool)
 {
@@ -63,6 +64,7 @@ void Render::draw(
   zoom_ = zoom;
   windowW_ = static_cast<float>(windowW);
   windowH_ = static_cast<float>(windowH);
+  updateMouseNet();
 
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   glUseProgram(fillProgramId_);
@@ -132,19 +134,18 @@ void Render::drawWireSections()
 void Render::drawComponents()
 {
   componentText_.setFontH(static_cast<int>(CIRCUIT_FONT_SIZE * zoom_));
-  for (auto ci : layout_->circuit.componentNameToComponentMap) {
+  for (auto ci : layout_->circuit().componentNameToComponentMap) {
     auto& componentName = ci.first;
     auto& component = ci.second;
     // Footprint
-    auto footprint = layout_->circuit.calcComponentFootprint(componentName);
+    auto footprint = layout_->circuit().calcComponentFootprint(componentName);
     auto start = footprint.start.cast<float>() - 0.5f;
     auto end = footprint.end.cast<float>() + 0.5f;
     drawFilledRectangle(start, end, RGBA(0, 0, 0, 0.4f));
     // Pins
     bool isPin0 = true;
     int pinIdx = 0;
-    for (auto pinVia : const_cast<Layout&>(*layout_).circuit.calcComponentPins(
-             componentName)) {
+    for (auto pinVia : layout_->circuit().calcComponentPins(componentName)) {
       auto isDontCarePin = component.dontCarePinIdxSet.count(pinIdx) > 0;
       RGBA rgba = isDontCarePin ? RGBA(0.0f, .784f, 0.0f, 1.0f)
                                 : RGBA(.784f, 0.0f, 0.0f, 1.0f);
@@ -206,7 +207,7 @@ void Render::drawStripCuts()
 void Render::drawRatsNest(bool showOnlyFailedBool)
 {
   auto& routedConVec = layout_->routeStatusVec;
-  auto allConVec = layout_->circuit.genConnectionViaVec();
+  auto allConVec = layout_->circuit().genConnectionViaVec();
   int i = 0;
   for (auto c : allConVec) {
     auto blueRgba = RGBA(0, .392f, .784f, 0.5f); // not yet routed
@@ -238,7 +239,7 @@ void Render::drawRatsNest(bool showOnlyFailedBool)
 void Render::drawBorder()
 {
   Pos start = Pos(0, 0) - 0.5f;
-  Pos end = Pos(layout_->gridW - 1, layout_->gridH - 1) + 0.5f;
+  Pos end = Pos(layout_->gridW() - 1, layout_->gridH() - 1) + 0.5f;
   RGBA rgba(0, 0, 0, 1);
   float radius = 0.2f;
   drawThickLine(
@@ -264,9 +265,9 @@ void Render::drawDiag()
     drawFilledCircle(v.via.cast<float>(), 1, rgba);
   }
   // Draw dots where costs have been set.
-  for (int y = 0; y < layout_->gridH; ++y) {
-    for (int x = 0; x < layout_->gridW; ++x) {
-      int idx = x + layout_->gridW * y;
+  for (int y = 0; y < layout_->gridH(); ++y) {
+    for (int x = 0; x < layout_->gridW(); ++x) {
+      int idx = x + layout_->gridW() * y;
       auto v = layout_->diagCostVec[idx];
       if (v.wireCost != INT_MAX) {
         drawFilledCircle(Pos(x - 0.2f, y), 0.75f, RGBA(1, 0, 0, 1));
@@ -288,8 +289,8 @@ void Render::drawDiag()
     printNotation(layout_->diagEndVia.via.cast<float>(), 0, "end");
   }
   // Draw wire jump labels
-  for (int y = 0; y < layout_->gridH; ++y) {
-    for (int x = 0; x < layout_->gridW; ++x) {
+  for (int y = 0; y < layout_->gridH(); ++y) {
+    for (int x = 0; x < layout_->gridW(); ++x) {
       auto& wireToVia =
           layout_->diagTraceVec[layout_->idx(Via(x, y))].wireToVia;
       if (wireToVia.isValid) {
@@ -324,16 +325,12 @@ void Render::drawDiag()
         fmt::format("wireBlocked: {}", viaTrace.isWireSideBlocked));
     // Nets
     printNotation(mouseBoardPos_, nLine++, fmt::format(""));
-    auto setIdxSize = layout_->setIdxVec.size();
-    //    printNotation(mouseBoardPos_,
-    //                  nLine++,
-    //                  fmt::format("setIdxSize: {}", setIdxSize));
-    if (setIdxSize) {
-      auto setIdx = layout_->setIdxVec[idx];
-      printNotation(mouseBoardPos_, nLine++, fmt::format("setIdx: {}", setIdx));
+    auto netRootIdx = findNetRoot(*layout_, idx);
+    printNotation(
+        mouseBoardPos_, nLine++, fmt::format("netRootIdx: {}", netRootIdx));
+    if (netRootIdx != -1) {
       printNotation(
-          mouseBoardPos_, nLine++,
-          fmt::format("setSize: {}", layout_->viaSetVec[setIdx].size()));
+          mouseBoardPos_, nLine++, fmt::format("netSize: {}", mouseNet_.size()));
     }
   }
 }
@@ -516,8 +513,8 @@ ValidVia Render::getMouseVia()
   Via v =
       Via(static_cast<int>(mouseBoardPos_.x() + 0.5f),
           static_cast<int>(mouseBoardPos_.y() + 0.5f));
-  if (v.x() >= 0 && v.y() >= 0 && v.x() < layout_->gridW
-      && v.y() < layout_->gridH) {
+  if (v.x() >= 0 && v.y() >= 0 && v.x() < layout_->gridW()
+      && v.y() < layout_->gridH()) {
     return ValidVia(v, true);
   }
   else {
@@ -527,18 +524,17 @@ ValidVia Render::getMouseVia()
 
 ViaSet& Render::getMouseNet()
 {
-  static auto emptyViaSet = ViaSet();
+  return mouseNet_;
+}
+
+// The nets only store the root of the net of each via, so the members of the
+// net under the mouse are found by scanning the grid once per draw().
+void Render::updateMouseNet()
+{
+  mouseNet_.clear();
   auto v = getMouseVia();
   if (!v.isValid) {
-    return emptyViaSet;
-  }
-  auto idx = layout_->idx(v.via);
-  assert(idx < static_cast<int>(layout_->setIdxVec.size()));
-  auto setIdx = layout_->setIdxVec[idx];
-  if (setIdx == -1) {
-    return emptyViaSet;
-  }
-  else {
-    return layout_->viaSetVec[setIdx];
+    return;
   }
+  mouseNet_ = getNetViaSet(*layout_, v.via);
 }
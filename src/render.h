@@ -23,7 +23,7 @@ class Render
   void openGLInit();
   void openGLFree();
   void draw(
-      Layout& layout, glm::mat4x4& projMat, const Pos& boardScreenOffset,
+      const Layout& layout, glm::mat4x4& projMat, const Pos& boardScreenOffset,
       const Pos& mouseBoardPos, float zoom, int windowW, int windowH,
       bool showRatsNestBool, bool showOnlyFailedBool);
 
@@ -49,11 +49,14 @@ class Render
   float setAlpha(const Via&);
   ValidVia getMouseVia();
   ViaSet& getMouseNet();
+  void updateMouseNet();
 
   OglText componentText_;
   OglText notationText_;
 
-  Layout* layout_;
+  const Layout* layout_;
+  // Vias in the net under the mouse, found once per draw()
+  ViaSet mouseNet_;
   glm::mat4x4 projMat_;
   Pos boardScreenOffset_;
   Pos mouseBoardPos_;
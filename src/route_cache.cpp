@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+#include "route_cache.h"
+
+//
+// RouterState
+//
+
+// Approximate, as the allocator overhead of the containers is not known.
+size_t RouterState::calcMemoryBytes() const
+{
+  size_t n = sizeof(RouterState);
+  for (auto& routeSectionVec : routeVec) {
+    n += sizeof(RouteSectionVec)
+         + routeSectionVec.capacity() * sizeof(LayerStartEndVia);
+  }
+  n += routeStatusVec.capacity() / 8;
+  n += netParentIdxVec.capacity() * sizeof(int);
+  n += netRankVec.capacity();
+  n += viaTraceVec.capacity() * sizeof(WireLayerVia);
+  return n;
+}
+
+//
+// RouteCacheStats
+//
+
+RouteCacheStats::RouteCacheStats()
+  : nLookups(0), nHits(0), nReusedRoutes(0), nEntries(0), memoryBytes(0)
+{
+}
+
+//
+// RouteCache
+//
+
+RouteCache::RouteCache(int maxEntries, int snapshotInterval)
+  : maxEntries_(maxEntries), snapshotInterval_(snapshotInterval)
+{
+  assert(maxEntries_ > 0);
+  assert(snapshotInterval_ > 0);
+}
+
+// Return the number of routes in the longest prefix of the ordering for which
+// there is a snapshot, and the snapshot. Return 0 if there is none.
+int RouteCache::findLongestPrefix(
+    Layout& layout, const ConnectionIdxVec& connectionIdxVec,
+    RouterStatePtr& routerState)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  clearIfOtherLayout(layout);
+  ++stats_.nLookups;
+  int nRoutesInOrdering = static_cast<int>(connectionIdxVec.size());
+  hashVec_.resize(nRoutesInOrdering + 1);
+  hashVec_[0] = 0;
+  for (int i = 0; i < nRoutesInOrdering; ++i) {
+    hashVec_[i + 1] = hashPrefix(hashVec_[i], connectionIdxVec[i]);
+  }
+  for (int nRoutes = nRoutesInOrdering; nRoutes > 0; --nRoutes) {
+    if (!isSnapshotPoint(nRoutes, nRoutesInOrdering)) {
+      continue;
+    }
+    auto itr = entryMap_.find(hashVec_[nRoutes]);
+    if (itr == entryMap_.end()
+        || static_cast<int>(itr->second->prefix.size()) != nRoutes
+        || !isPrefix(itr->second->prefix, connectionIdxVec)) {
+      continue;
+    }
+    entryList_.splice(entryList_.begin(), entryList_, itr->second);
+    routerState = itr->second->routerState;
+    ++stats_.nHits;
+    stats_.nReusedRoutes += nRoutes;
+    return nRoutes;
+  }
+  return 0;
+}
+
+bool RouteCache::isSnapshotPoint(int nRoutes, int nRoutesInOrdering)
+{
+  return !(nRoutes % snapshotInterval_) || nRoutes == nRoutesInOrdering;
+}
+
+void RouteCache::insert(
+    Layout& layout, const ConnectionIdxVec& connectionIdxVec, int nRoutes,
+    RouterStatePtr routerState)
+{
+  Entry entry;
+  entry.hash = 0;
+  for (int i = 0; i < nRoutes; ++i) {
+    entry.hash = hashPrefix(entry.hash, connectionIdxVec[i]);
+  }
+  entry.prefix.assign(
+      connectionIdxVec.begin(), connectionIdxVec.begin() + nRoutes);
+  entry.memoryBytes = routerState->calcMemoryBytes()
+                      + entry.prefix.capacity() * sizeof(ConnectionIdx);
+  entry.routerState = std::move(routerState);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  clearIfOtherLayout(layout);
+  // Another thread may have inserted the same prefix, or a different prefix
+  // with the same hash. Either way, the new snapshot replaces the old.
+  auto itr = entryMap_.find(entry.hash);
+  if (itr != entryMap_.end()) {
+    stats_.memoryBytes -= itr->second->memoryBytes;
+    entryList_.erase(itr->second);
+    entryMap_.erase(itr);
+  }
+  stats_.memoryBytes += entry.memoryBytes;
+  entryList_.push_front(std::move(entry));
+  entryMap_[entryList_.front().hash] = entryList_.begin();
+  while (static_cast<int>(entryList_.size()) > maxEntries_) {
+    auto& lru = entryList_.back();
+    stats_.memoryBytes -= lru.memoryBytes;
+    entryMap_.erase(lru.hash);
+    entryList_.pop_back();
+  }
+  stats_.nEntries = static_cast<long>(entryList_.size());
+}
+
+RouteCacheStats RouteCache::getStats()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+//
+// Private
+//
+
+void RouteCache::clearIfOtherLayout(Layout& layout)
+{
+  if (layout.getBaseTimestamp() == baseTimestamp_) {
+    return;
+  }
+  baseTimestamp_ = layout.getBaseTimestamp();
+  entryList_.clear();
+  entryMap_.clear();
+  stats_ = RouteCacheStats();
+}
+
+size_t RouteCache::hashPrefix(size_t hash, ConnectionIdx connectionIdx)
+{
+  // boost::hash_combine
+  return hash
+         ^ (std::hash<ConnectionIdx>()(connectionIdx) + 0x9e3779b9 + (hash << 6)
+            + (hash >> 2));
+}
+
+bool RouteCache::isPrefix(
+    const ConnectionIdxVec& prefix, const ConnectionIdxVec& v)
+{
+  return prefix.size() <= v.size()
+         && std::equal(prefix.begin(), prefix.end(), v.begin());
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "ga_interface.h"
+#include "layout.h"
+#include "via.h"
+
+// Orderings from the GA often share long prefixes with orderings that have
+// already been routed, and routing is deterministic, so the Router state after
+// routing a given prefix is always the same. This cache holds snapshots of the
+// Router state, keyed by the ordering prefix that produced them, so that
+// routing of an ordering can resume from its longest cached prefix.
+//
+// Snapshots are taken every snapshotInterval routes and after the last route.
+// The cache holds up to maxEntries snapshots and evicts the least recently
+// used. It is shared by all router threads. The snapshots are immutable once
+// inserted, so they are copied out without holding the lock.
+//
+// The cache is only valid for a single input layout. It is cleared when it is
+// used with a layout that has a different base timestamp.
+
+class RouterState
+{
+  public:
+  size_t calcMemoryBytes() const;
+  // Layout
+  long cost;
+  int nCompletedRoutes;
+  int nFailedRoutes;
+  RouteVec routeVec;
+  RouteStatusVec routeStatusVec;
+  SetIdxVec netParentIdxVec;
+  NetRankVec netRankVec;
+  // Router
+  WireLayerViaVec viaTraceVec;
+  bool hasWireJumps;
+};
+
+typedef std::shared_ptr<const RouterState> RouterStatePtr;
+
+class RouteCacheStats
+{
+  public:
+  RouteCacheStats();
+  long nLookups;
+  long nHits;
+  long nReusedRoutes;
+  long nEntries;
+  size_t memoryBytes;
+};
+
+class RouteCache
+{
+  public:
+  RouteCache(int maxEntries, int snapshotInterval);
+  int findLongestPrefix(
+      Layout& layout, const ConnectionIdxVec& connectionIdxVec,
+      RouterStatePtr& routerState);
+  bool isSnapshotPoint(int nRoutes, int nRoutesInOrdering);
+  void insert(
+      Layout& layout, const ConnectionIdxVec& connectionIdxVec, int nRoutes,
+      RouterStatePtr routerState);
+  RouteCacheStats getStats();
+
+  private:
+  class Entry
+  {
+    public:
+    size_t hash;
+    ConnectionIdxVec prefix;
+    RouterStatePtr routerState;
+    size_t memoryBytes;
+  };
+  typedef std::list<Entry> EntryList;
+
+  void clearIfOtherLayout(Layout& layout);
+  size_t hashPrefix(size_t hash, ConnectionIdx connectionIdx);
+  bool isPrefix(const ConnectionIdxVec& prefix, const ConnectionIdxVec& v);
+
+  int maxEntries_;
+  int snapshotInterval_;
+  std::mutex mutex_;
+  Timestamp baseTimestamp_;
+  // Most recently used first
+  EntryList entryList_;
+  std::unordered_map<size_t, EntryList::iterator> entryMap_;
+  RouteCacheStats stats_;
+  std::vector<size_t> hashVec_;
+};
@@ -6,20 +6,34 @@
 #include "router.h"
 #include "ucs.h"
 
+RouteBound::RouteBound() : nCompletedRoutes(0), cost(0), isValid(false)
+{
+}
+
+RouteBound::RouteBound(int _nCompletedRoutes, long _cost)
+  : nCompletedRoutes(_nCompletedRoutes), cost(_cost), isValid(true)
+{
+}
+
 Router::Router(
-    Layout& _layout, ConnectionIdxVec& connectionIdxVec, ThreadStop& threadStop,
-    Layout& _inputLayout, Layout& _currentLayout,
-    const TimeDuration& _maxRenderDelay)
+    Layout& _layout, ConnectionIdxVec& connectionIdxVec,
+    const CancellationToken& cancellationToken, PublishedLayout& _currentLayout,
+    const TimeDuration& _maxRenderDelay, SearchWorkspace& searchWorkspace,
+    const RouteBound& routeBound, RouteCache& routeCache)
   : layout_(_layout),
     connectionIdxVec_(connectionIdxVec),
-    inputLayout_(_inputLayout),
     currentLayout_(_currentLayout),
     nets_(_layout),
-    threadStop_(threadStop),
+    cancellationToken_(cancellationToken),
     allPinSet_(ViaSet()),
+    hasWireJumps_(false),
+    searchWorkspace_(searchWorkspace),
+    routeBound_(routeBound),
+    isCutOff_(false),
+    routeCache_(routeCache),
     maxRenderDelay_(_maxRenderDelay)
 {
-  viaTraceVec_ = WireLayerViaVec(layout_.gridW * layout_.gridH);
+  viaTraceVec_ = WireLayerViaVec(layout_.gridW() * layout_.gridH());
 }
 
 bool Router::route()
@@ -28,9 +42,13 @@ bool Router::route()
   joinAllConnections();
   registerActiveComponentPins();
   auto isAborted = routeAll();
+  // A layout that was cut off is not complete, so it is not evaluated.
+  if (isCutOff_) {
+    return isAborted;
+  }
   layout_.stripCutVec = findStripCuts();
-  layout_.cost +=
-      layout_.settings.cut_cost * static_cast<int>(layout_.stripCutVec.size());
+  layout_.cost += layout_.settings().cut_cost
+                  * static_cast<int>(layout_.stripCutVec.size());
   layout_.isReadyForEval = true;
   if (layout_.hasError) {
     layout_.diagTraceVec = viaTraceVec_;
@@ -38,6 +56,23 @@ bool Router::route()
   return isAborted;
 }
 
+// True if routing of the ordering was stopped because it could no longer beat
+// the RouteBound.
+bool Router::isCutOff()
+{
+  return isCutOff_;
+}
+
+// For an ordering that was cut off, the completed routes and cost at the
+// point it was cut off, with the routes that were not reached counted as
+// failed. This is passed to the GA as the fitness of the ordering. It is below
+// the RouteBound, and orderings that are cut off early rank below those that
+// get close to the best layout.
+RouteBound Router::getCutOffFitness()
+{
+  return cutOffFitness_;
+}
+
 //
 // Private
 //
@@ -46,10 +81,33 @@ bool Router::routeAll()
 {
   bool isAborted = false;
   auto startTime = std::chrono::steady_clock::now();
-  auto connectionViaVec = layout_.circuit.genConnectionViaVec();
+  auto connectionViaVec = layout_.circuit().genConnectionViaVec();
   layout_.routeStatusVec.resize(connectionViaVec.size(), false);
-  for (auto connectionIdx : connectionIdxVec_) {
+  int nRoutesInOrdering = static_cast<int>(connectionIdxVec_.size());
+  int nCachedRoutes = 0;
+  if (layout_.settings().use_route_cache) {
+    nCachedRoutes = restoreFromCache();
+  }
+  int nRemainingRoutes = nRoutesInOrdering - nCachedRoutes;
+  long remainingCostBound = 0;
+  if (routeBound_.isValid) {
+    for (int i = nCachedRoutes; i < nRoutesInOrdering; ++i) {
+      remainingCostBound +=
+          getRouteCostBound(connectionViaVec[connectionIdxVec_[i]]);
+    }
+  }
+  for (int i = nCachedRoutes; i < nRoutesInOrdering; ++i) {
+    auto connectionIdx = connectionIdxVec_[i];
     auto viaStartEnd = connectionViaVec[connectionIdx];
+    if (isOutOfBound(nRemainingRoutes, remainingCostBound)) {
+      isCutOff_ = true;
+      cutOffFitness_ = RouteBound(layout_.nCompletedRoutes, layout_.cost);
+      break;
+    }
+    --nRemainingRoutes;
+    if (routeBound_.isValid) {
+      remainingCostBound -= getRouteCostBound(viaStartEnd);
+    }
     auto routeWasFound = findCompleteRoute(viaStartEnd);
     layout_.routeStatusVec[connectionIdx] = routeWasFound;
 
@@ -63,23 +121,19 @@ bool Router::routeAll()
 //    }
 #endif
 
-    if (threadStop_.isStopped()) {
+    if (cancellationToken_.isCancelled()) {
       isAborted = true;
       break;
     }
-    {
-      auto lock = inputLayout_.scopeLock();
-      if (!layout_.isBasedOn(inputLayout_)) {
-        isAborted = true;
-        break;
-      }
-    }
     if (layout_.hasError) {
       break;
     }
+    if (layout_.settings().use_route_cache
+        && routeCache_.isSnapshotPoint(i + 1, nRoutesInOrdering)) {
+      saveToCache(i + 1);
+    }
     if (std::chrono::steady_clock::now() - startTime > maxRenderDelay_) {
-      auto lock = currentLayout_.scopeLock();
-      currentLayout_ = layout_;
+      currentLayout_.publish(std::make_shared<const Layout>(layout_));
       startTime = std::chrono::steady_clock::now();
       layout_.isReadyForEval = true;
     }
@@ -87,6 +141,74 @@ bool Router::routeAll()
   return isAborted;
 }
 
+// The layout cannot beat the bound if it cannot get more completed routes or,
+// if it can at most tie on completed routes, it cannot get a lower cost. A tie
+// requires all the remaining routes to be completed, and each of them costs at
+// least its getRouteCostBound(). Strip cuts only add to the cost.
+bool Router::isOutOfBound(int nRemainingRoutes, long remainingCostBound)
+{
+  if (!routeBound_.isValid) {
+    return false;
+  }
+  int nMaxCompletedRoutes = layout_.nCompletedRoutes + nRemainingRoutes;
+  if (nMaxCompletedRoutes < routeBound_.nCompletedRoutes) {
+    return true;
+  }
+  return nMaxCompletedRoutes == routeBound_.nCompletedRoutes
+         && layout_.cost + remainingCostBound >= routeBound_.cost;
+}
+
+// Resume from the state after the longest prefix of the ordering that is in
+// the RouteCache. Return the number of routes in the prefix.
+int Router::restoreFromCache()
+{
+  RouterStatePtr routerState;
+  int nRoutes =
+      routeCache_.findLongestPrefix(layout_, connectionIdxVec_, routerState);
+  if (!nRoutes) {
+    return 0;
+  }
+  layout_.cost = routerState->cost;
+  layout_.nCompletedRoutes = routerState->nCompletedRoutes;
+  layout_.nFailedRoutes = routerState->nFailedRoutes;
+  layout_.routeVec = routerState->routeVec;
+  layout_.routeStatusVec = routerState->routeStatusVec;
+  layout_.netParentIdxVec = routerState->netParentIdxVec;
+  layout_.netRankVec = routerState->netRankVec;
+  viaTraceVec_ = routerState->viaTraceVec;
+  hasWireJumps_ = routerState->hasWireJumps;
+  return nRoutes;
+}
+
+void Router::saveToCache(int nRoutes)
+{
+  auto routerState = std::make_shared<RouterState>();
+  routerState->cost = layout_.cost;
+  routerState->nCompletedRoutes = layout_.nCompletedRoutes;
+  routerState->nFailedRoutes = layout_.nFailedRoutes;
+  routerState->routeVec = layout_.routeVec;
+  routerState->routeStatusVec = layout_.routeStatusVec;
+  routerState->netParentIdxVec = layout_.netParentIdxVec;
+  routerState->netRankVec = layout_.netRankVec;
+  routerState->viaTraceVec = viaTraceVec_;
+  routerState->hasWireJumps = hasWireJumps_;
+  routeCache_.insert(layout_, connectionIdxVec_, nRoutes, routerState);
+}
+
+// Lower bound for the cost of a route. Vertical steps are only possible on the
+// strip layer. Any horizontal distance costs at least one wire_cost, which is
+// the cost of a jump along an existing wire.
+int Router::getRouteCostBound(const StartEndVia& viaStartEnd)
+{
+  const Settings& settings = layout_.settings();
+  auto d = (viaStartEnd.end - viaStartEnd.start).abs();
+  int cost = d.y() * settings.strip_cost;
+  if (d.x()) {
+    cost += settings.wire_cost;
+  }
+  return cost;
+}
+
 // There are two main approaches possible when routing with potential shortcut.
 //
 // (1) If, when routing from A to B, the router starts at A, finds a shortcut to
@@ -116,8 +238,9 @@ bool Router::findCompleteRoute(const StartEndVia& viaStartEnd)
 
 bool Router::findRoute(Via& shortcutEndVia, const StartEndVia& viaStartEnd)
 {
-  UniformCostSearch ucs(*this, layout_, nets_, shortcutEndVia, viaStartEnd);
-  auto routeStepVec = ucs.findLowestCostRoute();
+  UniformCostSearch ucs(
+      *this, layout_, nets_, shortcutEndVia, viaStartEnd, searchWorkspace_);
+  const auto& routeStepVec = ucs.findLowestCostRoute();
   if (layout_.hasError || !routeStepVec.size()) {
     return false;
   }
@@ -165,9 +288,9 @@ RouteSectionVec Router::condenseRoute(const RouteStepVec& routeStepVec)
 StripCutVec Router::findStripCuts()
 {
   StripCutVec v;
-  for (int x = 0; x < layout_.gridW; ++x) {
+  for (int x = 0; x < layout_.gridW(); ++x) {
     bool isUsed = false;
-    for (int y = 1; y < layout_.gridH; ++y) {
+    for (int y = 1; y < layout_.gridH(); ++y) {
       Via prevVia(x, y - 1);
       Via curVia(x, y);
       auto isConnected = nets_.isConnected(curVia, prevVia);
@@ -191,8 +314,8 @@ StripCutVec Router::findStripCuts()
 bool Router::isAvailable(
     const LayerVia& via, const Via& startVia, const Via& targetVia)
 {
-  if (via.via.x() < 0 || via.via.y() < 0 || via.via.x() >= layout_.gridW
-      || via.via.y() >= layout_.gridH) {
+  if (via.via.x() < 0 || via.via.y() < 0 || via.via.x() >= layout_.gridW()
+      || via.via.y() >= layout_.gridH()) {
     return false;
   }
   if (via.isWireLayer) {
@@ -237,6 +360,11 @@ bool Router::isAnyPin(const Via& via)
   return allPinSet_.count(via) > 0;
 }
 
+bool Router::hasWireJumps()
+{
+  return hasWireJumps_;
+}
+
 ValidVia& Router::wireToViaRef(const Via& via)
 {
   return viaTraceVec_[layout_.idx(via)].wireToVia;
@@ -249,9 +377,9 @@ ValidVia& Router::wireToViaRef(const Via& via)
 void Router::blockComponentFootprints()
 {
   // Block the entire component footprint on the wire layer
-  for (auto& ci : layout_.circuit.componentNameToComponentMap) {
+  for (auto& ci : layout_.circuit().componentNameToComponentMap) {
     const auto& componentName = ci.first;
-    auto footprint = layout_.circuit.calcComponentFootprint(componentName);
+    auto footprint = layout_.circuit().calcComponentFootprint(componentName);
     for (int y = footprint.start.y(); y <= footprint.end.y(); ++y) {
       for (int x = footprint.start.x(); x <= footprint.end.x(); ++x) {
         block(Via(x, y));
@@ -285,17 +413,17 @@ bool Router::isBlocked(const Via& via)
 
 void Router::joinAllConnections()
 {
-  for (auto& c : layout_.circuit.genConnectionViaVec()) {
+  for (auto& c : layout_.circuit().genConnectionViaVec()) {
     nets_.connect(c.start, c.end);
   }
 }
 
 void Router::registerActiveComponentPins()
 {
-  for (auto& ci : layout_.circuit.componentNameToComponentMap) {
+  for (auto& ci : layout_.circuit().componentNameToComponentMap) {
     const auto& componentName = ci.first;
     const auto& component = ci.second;
-    auto pinViaVec = layout_.circuit.calcComponentPins(componentName);
+    auto pinViaVec = layout_.circuit().calcComponentPins(componentName);
     auto pinIdx = 0;
     for (auto via : pinViaVec) {
       if (!component.dontCarePinIdxSet.count(pinIdx)) {
@@ -315,6 +443,7 @@ void Router::addWireJumps(const RouteSectionVec& routeSectionVec)
     if (start.isWireLayer) {
       wireToViaRef(start.via) = ValidVia(end.via, true);
       wireToViaRef(end.via) = ValidVia(start.via, true);
+      hasWireJumps_ = true;
     }
   }
 }
@@ -12,29 +12,54 @@
 #include "ga_interface.h"
 #include "layout.h"
 #include "nets.h"
+#include "published_layout.h"
+#include "route_cache.h"
 #include "settings.h"
 #include "thread_stop.h"
+#include "ucs.h"
 #include "via.h"
 
 typedef std::chrono::duration<double> TimeDuration;
 
+// Number of completed routes and cost of a layout, used as the bound for
+// branch-and-bound routing. With a valid bound, the router cuts off an
+// ordering as soon as it can no longer beat the bound.
+class RouteBound
+{
+  public:
+  RouteBound();
+  RouteBound(int nCompletedRoutes, long cost);
+  int nCompletedRoutes;
+  long cost;
+  bool isValid;
+};
+
 class Router
 {
   public:
   Router(
-      Layout&, ConnectionIdxVec&, ThreadStop&, Layout& inputLayout,
-      Layout& currentLayout, const TimeDuration& _maxRenderDelay);
+      Layout&, ConnectionIdxVec&, const CancellationToken&,
+      PublishedLayout& currentLayout, const TimeDuration& _maxRenderDelay,
+      SearchWorkspace& searchWorkspace, const RouteBound& routeBound,
+      RouteCache& routeCache);
   bool route();
+  bool isCutOff();
+  RouteBound getCutOffFitness();
   // Interface for Uniform Cost Search
   bool isAvailable(
       const LayerVia& via, const Via& startVia, const Via& targetVia);
   bool isTarget(const LayerVia& via, const Via& targetVia);
   bool isTargetPin(const LayerVia& via, const Via& targetVia);
   bool isAnyPin(const Via& via);
+  bool hasWireJumps();
   ValidVia& wireToViaRef(const Via& via);
 
   private:
   bool routeAll();
+  bool isOutOfBound(int nRemainingRoutes, long remainingCostBound);
+  int getRouteCostBound(const StartEndVia&);
+  int restoreFromCache();
+  void saveToCache(int nRoutes);
   bool findCompleteRoute(const StartEndVia&);
   bool findRoute(Via& shortcutEndVia, const StartEndVia& viaStartEnd);
   RouteSectionVec condenseRoute(const RouteStepVec& routeStepVec);
@@ -52,14 +77,19 @@ class Router
 
   Layout& layout_;
   ConnectionIdxVec& connectionIdxVec_;
-  Layout& inputLayout_;
-  Layout& currentLayout_;
+  PublishedLayout& currentLayout_;
 
   Nets nets_;
-  ThreadStop& threadStop_;
+  const CancellationToken& cancellationToken_;
 
   WireLayerViaVec viaTraceVec_;
   ViaSet allPinSet_;
+  bool hasWireJumps_;
+  SearchWorkspace& searchWorkspace_;
+  const RouteBound& routeBound_;
+  bool isCutOff_;
+  RouteBound cutOffFitness_;
+  RouteCache& routeCache_;
 
   const TimeDuration& maxRenderDelay_;
 };
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#endif
+
+#include "search_checkpoint.h"
+
+const char CHECKPOINT_MAGIC[8] = { 'S', 'R', 'C', 'H', 'C', 'K', 'P', 'T' };
+const std::uint32_t CHECKPOINT_VERSION = 1;
+
+//
+// SearchCheckpoint
+//
+
+SearchCheckpoint::SearchCheckpoint()
+  : circuitHash(0),
+    randomSeed(0),
+    encodingType(EncodingType::Dependency),
+    bestNCompletedRoutes(0),
+    bestCost(0)
+{
+}
+
+//
+// Circuit hash
+//
+
+// FNV-1a, which gives the same hash on all platforms, unlike std::hash.
+void addToHash(std::uint64_t& hash, const void* data, size_t nBytes)
+{
+  auto p = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < nBytes; ++i) {
+    hash = (hash ^ p[i]) * 0x100000001b3;
+  }
+}
+
+void addToHash(std::uint64_t& hash, const std::string& s)
+{
+  addToHash(hash, s.c_str(), s.size() + 1);
+}
+
+void addToHash(std::uint64_t& hash, std::int32_t v)
+{
+  addToHash(hash, &v, sizeof(v));
+}
+
+// The package definitions only matter through the component pin positions,
+// and the component map is ordered by name, so equal circuits give equal
+// hashes.
+std::uint64_t calcCircuitHash(const Circuit& circuit)
+{
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (auto& nameComponent : circuit.componentNameToComponentMap) {
+    addToHash(hash, nameComponent.first);
+    addToHash(hash, nameComponent.second.packageName);
+    for (auto& pinVia : circuit.calcComponentPins(nameComponent.first)) {
+      addToHash(hash, pinVia.x());
+      addToHash(hash, pinVia.y());
+    }
+  }
+  for (auto& connection : circuit.connectionVec) {
+    addToHash(hash, connection.start.componentName);
+    addToHash(hash, connection.start.pinIdx);
+    addToHash(hash, connection.end.componentName);
+    addToHash(hash, connection.end.pinIdx);
+  }
+  return hash;
+}
+
+//
+// SearchCheckpointFile
+//
+
+template <typename T>
+void writeValue(std::ofstream& outFile, T v)
+{
+  outFile.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+template <typename T>
+T readValue(std::ifstream& inFile)
+{
+  T v;
+  inFile.read(reinterpret_cast<char*>(&v), sizeof(v));
+  if (!inFile.good()) {
+    throw std::runtime_error("Checkpoint file is truncated");
+  }
+  return v;
+}
+
+void writeGeneVec(std::ofstream& outFile, const GeneVec& geneVec)
+{
+  writeValue<std::uint32_t>(
+      outFile, static_cast<std::uint32_t>(geneVec.size()));
+  for (auto gene : geneVec) {
+    writeValue<std::int32_t>(outFile, gene);
+  }
+}
+
+GeneVec readGeneVec(std::ifstream& inFile)
+{
+  auto nGenes = readValue<std::uint32_t>(inFile);
+  GeneVec geneVec;
+  for (std::uint32_t i = 0; i < nGenes; ++i) {
+    geneVec.push_back(readValue<std::int32_t>(inFile));
+  }
+  return geneVec;
+}
+
+// rename() does not replace an existing file on Windows.
+bool replaceFile(const std::string& fromPath, const std::string& toPath)
+{
+#if defined(_WIN32)
+  return MoveFileExA(
+      fromPath.c_str(), toPath.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else
+  return !rename(fromPath.c_str(), toPath.c_str());
+#endif
+}
+
+void SearchCheckpointFile::write(
+    const std::string& filePath, const SearchCheckpoint& checkpoint)
+{
+  auto tmpFilePath = filePath + ".tmp";
+  std::ofstream outFile(tmpFilePath, std::ios::binary | std::ios::trunc);
+  if (!outFile.good()) {
+    throw std::runtime_error(
+        fmt::format("Could not open file for write. path=\"{}\"", tmpFilePath));
+  }
+  outFile.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+  writeValue<std::uint32_t>(outFile, CHECKPOINT_VERSION);
+  writeValue<std::uint64_t>(outFile, checkpoint.circuitHash);
+  writeValue<std::uint64_t>(outFile, checkpoint.randomSeed);
+  writeValue<std::uint32_t>(
+      outFile, static_cast<std::uint32_t>(checkpoint.encodingType));
+  writeValue<std::uint32_t>(
+      outFile, static_cast<std::uint32_t>(checkpoint.populationVec.size()));
+  for (auto& population : checkpoint.populationVec) {
+    for (auto s : population.randomEngineState) {
+      writeValue<std::uint64_t>(outFile, s);
+    }
+    writeValue<std::uint32_t>(
+        outFile, static_cast<std::uint32_t>(population.organismVec.size()));
+    for (auto& organism : population.organismVec) {
+      writeValue<std::uint8_t>(outFile, organism.isEvaluated);
+      writeValue<std::int32_t>(outFile, organism.nCompletedRoutes);
+      writeValue<std::int64_t>(outFile, organism.completedRouteCost);
+      writeGeneVec(outFile, organism.geneVec);
+    }
+  }
+  writeGeneVec(outFile, checkpoint.bestConnectionIdxVec);
+  writeValue<std::int32_t>(outFile, checkpoint.bestNCompletedRoutes);
+  writeValue<std::int64_t>(outFile, checkpoint.bestCost);
+  outFile.close();
+  if (!outFile.good()) {
+    throw std::runtime_error(
+        fmt::format("Could not write file. path=\"{}\"", tmpFilePath));
+  }
+  if (!replaceFile(tmpFilePath, filePath)) {
+    throw std::runtime_error(fmt::format(
+        "Could not replace file. new=\"{}\" old=\"{}\"", tmpFilePath,
+        filePath));
+  }
+}
+
+SearchCheckpoint SearchCheckpointFile::read(const std::string& filePath)
+{
+  std::ifstream inFile(filePath, std::ios::binary);
+  if (!inFile.good()) {
+    throw std::runtime_error(
+        fmt::format("Could not open file for read. path=\"{}\"", filePath));
+  }
+  char magic[sizeof(CHECKPOINT_MAGIC)];
+  inFile.read(magic, sizeof(magic));
+  if (!inFile.good()
+      || !std::equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC)
+      || readValue<std::uint32_t>(inFile) != CHECKPOINT_VERSION) {
+    throw std::runtime_error(
+        fmt::format("Not a search checkpoint file. path=\"{}\"", filePath));
+  }
+  SearchCheckpoint checkpoint;
+  checkpoint.circuitHash = readValue<std::uint64_t>(inFile);
+  checkpoint.randomSeed = readValue<std::uint64_t>(inFile);
+  checkpoint.encodingType =
+      static_cast<EncodingType>(readValue<std::uint32_t>(inFile));
+  auto nPopulations = readValue<std::uint32_t>(inFile);
+  for (std::uint32_t i = 0; i < nPopulations; ++i) {
+    PopulationSnapshot population;
+    for (auto& s : population.randomEngineState) {
+      s = readValue<std::uint64_t>(inFile);
+    }
+    auto nOrganisms = readValue<std::uint32_t>(inFile);
+    for (std::uint32_t j = 0; j < nOrganisms; ++j) {
+      Organism organism(0, GeneEncoding());
+      organism.isEvaluated = readValue<std::uint8_t>(inFile) != 0;
+      organism.nCompletedRoutes = readValue<std::int32_t>(inFile);
+      organism.completedRouteCost =
+          static_cast<long>(readValue<std::int64_t>(inFile));
+      organism.geneVec = readGeneVec(inFile);
+      population.organismVec.push_back(organism);
+    }
+    checkpoint.populationVec.push_back(population);
+  }
+  checkpoint.bestConnectionIdxVec = readGeneVec(inFile);
+  checkpoint.bestNCompletedRoutes = readValue<std::int32_t>(inFile);
+  checkpoint.bestCost = static_cast<long>(readValue<std::int64_t>(inFile));
+  return checkpoint;
+}
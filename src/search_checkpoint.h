@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "circuit.h"
+#include "ga_core.h"
+#include "ga_interface.h"
+
+// The state of a search, saved periodically so that a long search can be
+// continued with --resume after the app is restarted. It holds the GA island
+// populations with their fitness and random state, and the best ordering
+// found, from which the best layout is routed again.
+//
+// A checkpoint is only valid for the circuit it was saved for, which is
+// identified by a hash of the components and connections. The random seed and
+// gene encoding must also be the same for the populations to be used.
+//
+// The file is binary, in the native byte order. It is written to a temporary
+// file that then replaces the previous checkpoint, so a crash during a write
+// does not lose the previous checkpoint.
+
+class SearchCheckpoint
+{
+  public:
+  SearchCheckpoint();
+  std::uint64_t circuitHash;
+  std::uint64_t randomSeed;
+  EncodingType encodingType;
+  std::vector<PopulationSnapshot> populationVec;
+  // Empty if no layout had been routed
+  ConnectionIdxVec bestConnectionIdxVec;
+  int bestNCompletedRoutes;
+  long bestCost;
+};
+
+std::uint64_t calcCircuitHash(const Circuit& circuit);
+
+class SearchCheckpointFile
+{
+  public:
+  void write(const std::string& filePath, const SearchCheckpoint& checkpoint);
+  SearchCheckpoint read(const std::string& filePath);
+};
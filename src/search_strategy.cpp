@@ -0,0 +1,83 @@
+#include "search_strategy.h"
+
+SearchStrategy::~SearchStrategy()
+{
+}
+
+//
+// GeneticSearch
+//
+
+GeneticSearch::GeneticSearch(GeneticAlgorithm& geneticAlgorithm)
+  : geneticAlgorithm_(geneticAlgorithm), nResets_(0)
+{
+}
+
+void GeneticSearch::reset(int)
+{
+}
+
+OrderingIdx GeneticSearch::reserveOrdering()
+{
+  auto lock = geneticAlgorithm_.scopeLock();
+  nResets_ = geneticAlgorithm_.getNumResets();
+  return geneticAlgorithm_.reserveOrdering();
+}
+
+// Only copying the genes requires the lock, not decoding them.
+ConnectionIdxVec GeneticSearch::getOrdering(OrderingIdx orderingIdx)
+{
+  GeneVec geneVec;
+  {
+    auto lock = geneticAlgorithm_.scopeLock();
+    geneVec = geneticAlgorithm_.getGenes(orderingIdx);
+  }
+  return geneticAlgorithm_.calcOrdering(geneVec);
+}
+
+void GeneticSearch::releaseOrdering(
+    OrderingIdx orderingIdx, int nCompletedRoutes, long completedRouteCost)
+{
+  auto lock = geneticAlgorithm_.scopeLock();
+  geneticAlgorithm_.releaseOrdering(
+      orderingIdx, nResets_, nCompletedRoutes, completedRouteCost);
+}
+
+//
+// RandomSearch
+//
+
+RandomSearch::RandomSearch(int randomStreamIdx)
+  : randomStreamIdx_(randomStreamIdx),
+    randomEngine_(getRandomSeed(), randomStreamIdx),
+    nConnectionsInCircuit_(0)
+{
+}
+
+void RandomSearch::reset(int nConnectionsInCircuit)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  nConnectionsInCircuit_ = nConnectionsInCircuit;
+  randomEngine_ = RandomEngine(getRandomSeed(), randomStreamIdx_);
+}
+
+OrderingIdx RandomSearch::reserveOrdering()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nConnectionsInCircuit_ ? 0 : -1;
+}
+
+ConnectionIdxVec RandomSearch::getOrdering(OrderingIdx)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  ConnectionIdxVec connectionIdxVec;
+  for (int i = 0; i < nConnectionsInCircuit_; ++i) {
+    connectionIdxVec.push_back(i);
+  }
+  randomEngine_.shuffle(connectionIdxVec);
+  return connectionIdxVec;
+}
+
+void RandomSearch::releaseOrdering(OrderingIdx, int, long)
+{
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mutex>
+
+#include "ga_island.h"
+#include "random_engine.h"
+
+// A search strategy provides the router threads with orderings to route and
+// receives the fitness of the resulting layouts, using the same reserve, get
+// and release sequence as GeneticAlgorithm. Each router thread has its own
+// SearchStrategy object, which may share state with the objects of other
+// threads, as the GA islands do. The methods do their own locking.
+//
+// reserveOrdering() returns -1 if no ordering is available yet, in which case
+// the caller must wait a bit and try again. The caller passes the returned
+// index to getOrdering() and releaseOrdering().
+
+class SearchStrategy
+{
+  public:
+  virtual ~SearchStrategy();
+  virtual void reset(int nConnectionsInCircuit) = 0;
+  virtual OrderingIdx reserveOrdering() = 0;
+  virtual ConnectionIdxVec getOrdering(OrderingIdx orderingIdx) = 0;
+  virtual void releaseOrdering(
+      OrderingIdx orderingIdx, int nCompletedRoutes,
+      long completedRouteCost) = 0;
+};
+
+// The GA island of a router thread. The islands are reset separately, through
+// the IslandModel, so that the population can be warm-started.
+class GeneticSearch : public SearchStrategy
+{
+  public:
+  GeneticSearch(GeneticAlgorithm& geneticAlgorithm);
+  void reset(int nConnectionsInCircuit) override;
+  OrderingIdx reserveOrdering() override;
+  ConnectionIdxVec getOrdering(OrderingIdx orderingIdx) override;
+  void releaseOrdering(
+      OrderingIdx orderingIdx, int nCompletedRoutes,
+      long completedRouteCost) override;
+
+  private:
+  GeneticAlgorithm& geneticAlgorithm_;
+  // Each router thread has its own GeneticSearch and reserves one ordering at
+  // a time, so this is the number of resets for the reserved ordering.
+  int nResets_;
+};
+
+// Random orderings. The fitness is ignored.
+class RandomSearch : public SearchStrategy
+{
+  public:
+  RandomSearch(int randomStreamIdx);
+  void reset(int nConnectionsInCircuit) override;
+  OrderingIdx reserveOrdering() override;
+  ConnectionIdxVec getOrdering(OrderingIdx orderingIdx) override;
+  void releaseOrdering(
+      OrderingIdx orderingIdx, int nCompletedRoutes,
+      long completedRouteCost) override;
+
+  private:
+  std::mutex mutex_;
+  int randomStreamIdx_;
+  RandomEngine randomEngine_;
+  int nConnectionsInCircuit_;
+};
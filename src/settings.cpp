@@ -5,6 +5,14 @@ Settings::Settings()
     strip_cost(DEFAULT_STRIP_COST),
     via_cost(DEFAULT_VIA_COST),
     cut_cost(DEFAULT_CUT_COST),
+    use_astar(false),
+    use_bucket_queue(false),
+    use_run_edges(false),
+    use_bidirectional(false),
+    use_route_bound(false),
+    use_route_cache(false),
+    use_fitness_cache(false),
+    use_steady_state_ga(false),
     pause(false)
 {
 }
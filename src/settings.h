@@ -15,5 +15,23 @@ class Settings
   int strip_cost;
   int via_cost;
   int cut_cost;
+  // Order the UCS frontier by cost plus an admissible estimate of the
+  // remaining cost (A*) instead of by cost alone (Dijkstra).
+  bool use_astar;
+  // Use a bucket queue instead of a binary heap for the UCS frontier.
+  bool use_bucket_queue;
+  // Expand whole strip and wire runs as single edges in the UCS.
+  bool use_run_edges;
+  // Search for routes from both ends at once.
+  bool use_bidirectional;
+  // Stop routing an ordering as soon as it cannot beat the best layout.
+  bool use_route_bound;
+  // Resume routing from cached router states for shared ordering prefixes.
+  bool use_route_cache;
+  // Reuse the fitness of orderings that have already been routed.
+  bool use_fitness_cache;
+  // Replace single organisms as they are evaluated instead of whole
+  // generations, so that router threads don't wait at generation boundaries.
+  bool use_steady_state_ga;
   bool pause;
 };
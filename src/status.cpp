@@ -1,7 +1,179 @@
 #include "status.h"
 
-std::mutex statusMutex;
+//
+// StatusCounts
+//
 
-Status::Status() : nCombinationsChecked(0)
+StatusCounts::StatusCounts()
+  : nCombinationsChecked(0),
+    nRoutes(0),
+    nExpandedNodes(0),
+    routingTime(0),
+    idleTime(0),
+    lockWaitTime(0)
 {
 }
+
+StatusCounts& StatusCounts::operator+=(const StatusCounts& s)
+{
+  nCombinationsChecked += s.nCombinationsChecked;
+  nRoutes += s.nRoutes;
+  nExpandedNodes += s.nExpandedNodes;
+  routingTime += s.routingTime;
+  idleTime += s.idleTime;
+  lockWaitTime += s.lockWaitTime;
+  return *this;
+}
+
+StatusCounts& StatusCounts::operator-=(const StatusCounts& s)
+{
+  nCombinationsChecked -= s.nCombinationsChecked;
+  nRoutes -= s.nRoutes;
+  nExpandedNodes -= s.nExpandedNodes;
+  routingTime -= s.routingTime;
+  idleTime -= s.idleTime;
+  lockWaitTime -= s.lockWaitTime;
+  return *this;
+}
+
+//
+// ThreadStatus
+//
+
+ThreadStatus::ThreadStatus()
+  : nCombinationsChecked_(0),
+    nRoutes_(0),
+    nExpandedNodes_(0),
+    routingNs_(0),
+    idleNs_(0),
+    lockWaitNs_(0)
+{
+}
+
+StatusCounts ThreadStatus::getCounts() const
+{
+  StatusCounts counts;
+  counts.nCombinationsChecked =
+      nCombinationsChecked_.load(std::memory_order_relaxed);
+  counts.nRoutes = nRoutes_.load(std::memory_order_relaxed);
+  counts.nExpandedNodes = nExpandedNodes_.load(std::memory_order_relaxed);
+  counts.routingTime =
+      std::chrono::nanoseconds(routingNs_.load(std::memory_order_relaxed));
+  counts.idleTime =
+      std::chrono::nanoseconds(idleNs_.load(std::memory_order_relaxed));
+  counts.lockWaitTime =
+      std::chrono::nanoseconds(lockWaitNs_.load(std::memory_order_relaxed));
+  return counts;
+}
+
+long ThreadStatus::getNumCombinationsChecked() const
+{
+  return nCombinationsChecked_.load(std::memory_order_relaxed);
+}
+
+void ThreadStatus::addCombinationChecked()
+{
+  add(nCombinationsChecked_, 1);
+}
+
+void ThreadStatus::addRouting(
+    long nRoutes, long nExpandedNodes, std::chrono::nanoseconds routingTime)
+{
+  add(nRoutes_, nRoutes);
+  add(nExpandedNodes_, nExpandedNodes);
+  add(routingNs_, static_cast<long>(routingTime.count()));
+}
+
+void ThreadStatus::addIdleTime(std::chrono::nanoseconds idleTime)
+{
+  add(idleNs_, static_cast<long>(idleTime.count()));
+}
+
+void ThreadStatus::addLockWaitTime(std::chrono::nanoseconds lockWaitTime)
+{
+  add(lockWaitNs_, static_cast<long>(lockWaitTime.count()));
+}
+
+// There is a single writer, so a plain load and store is enough, and is
+// cheaper than a locked read-modify-write.
+void ThreadStatus::add(std::atomic<long>& counter, long n)
+{
+  counter.store(
+      counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+//
+// Status
+//
+
+Status::Status() : nThreads_(0), resetNCombinationsChecked_(0)
+{
+  reset();
+}
+
+// Must be called before the router threads are launched.
+void Status::init(int nThreads)
+{
+  nThreads_ = nThreads;
+  threadStatusArr_.reset(new ThreadStatus[nThreads]);
+  resetCountsVec_.assign(nThreads, StatusCounts());
+}
+
+int Status::getNumThreads() const
+{
+  return nThreads_;
+}
+
+ThreadStatus& Status::getThreadStatus(int threadIdx)
+{
+  return threadStatusArr_[threadIdx];
+}
+
+void Status::reset()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  long nCombinationsChecked = 0;
+  for (int i = 0; i < nThreads_; ++i) {
+    resetCountsVec_[i] = threadStatusArr_[i].getCounts();
+    nCombinationsChecked += resetCountsVec_[i].nCombinationsChecked;
+  }
+  resetNCombinationsChecked_.store(
+      nCombinationsChecked, std::memory_order_relaxed);
+  resetTime_ = std::chrono::steady_clock::now();
+}
+
+StatusCounts Status::getThreadCounts(int threadIdx)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto counts = threadStatusArr_[threadIdx].getCounts();
+  counts -= resetCountsVec_[threadIdx];
+  return counts;
+}
+
+StatusCounts Status::getTotalCounts()
+{
+  StatusCounts totalCounts;
+  for (int i = 0; i < nThreads_; ++i) {
+    totalCounts += getThreadCounts(i);
+  }
+  return totalCounts;
+}
+
+// Lock free, for checking the number of checks after each ordering. Checks
+// made around a reset() may be counted on either side of it.
+long Status::getNumCombinationsChecked()
+{
+  long n = 0;
+  for (int i = 0; i < nThreads_; ++i) {
+    n += threadStatusArr_[i].getNumCombinationsChecked();
+  }
+  return n - resetNCombinationsChecked_.load(std::memory_order_relaxed);
+}
+
+double Status::getElapsedSec()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - resetTime_;
+  return elapsed.count();
+}
@@ -1,12 +1,87 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <mutex>
+#include <vector>
 
-extern std::mutex statusMutex;
+// Search statistics. Each router thread updates only its own ThreadStatus, so
+// there is no lock or shared cache line on the hot path. The totals are
+// aggregated when they are read.
+//
+// The counters are never cleared, as a reset from another thread could be
+// lost in an update. Instead, reset() takes a snapshot of the counters, and
+// the statistics are reported relative to it.
+
+const int CACHE_LINE_BYTES = 64;
+
+// A copy of the counters of a ThreadStatus, or of their sum over all threads
+class StatusCounts
+{
+  public:
+  StatusCounts();
+  StatusCounts& operator+=(const StatusCounts&);
+  StatusCounts& operator-=(const StatusCounts&);
+  long nCombinationsChecked;
+  // Routes searched by the router, not counting routes restored from the
+  // route cache
+  long nRoutes;
+  long nExpandedNodes;
+  // Time spent routing, waiting for work, and waiting for the input layout
+  // lock
+  std::chrono::nanoseconds routingTime;
+  std::chrono::nanoseconds idleTime;
+  std::chrono::nanoseconds lockWaitTime;
+};
+
+class ThreadStatus
+{
+  public:
+  ThreadStatus();
+  StatusCounts getCounts() const;
+  long getNumCombinationsChecked() const;
+  // Only to be called by the thread that owns the ThreadStatus
+  void addCombinationChecked();
+  void addRouting(
+      long nRoutes, long nExpandedNodes, std::chrono::nanoseconds routingTime);
+  void addIdleTime(std::chrono::nanoseconds idleTime);
+  void addLockWaitTime(std::chrono::nanoseconds lockWaitTime);
+
+  private:
+  static void add(std::atomic<long>& counter, long n);
+  std::atomic<long> nCombinationsChecked_;
+  std::atomic<long> nRoutes_;
+  std::atomic<long> nExpandedNodes_;
+  std::atomic<long> routingNs_;
+  std::atomic<long> idleNs_;
+  std::atomic<long> lockWaitNs_;
+  // Keeps the counters of the next ThreadStatus in an array off the cache
+  // line of these, without relying on over-aligned allocation.
+  char padding_[CACHE_LINE_BYTES];
+};
 
 class Status
 {
   public:
   Status();
-  int nCombinationsChecked;
+  void init(int nThreads);
+  int getNumThreads() const;
+  ThreadStatus& getThreadStatus(int threadIdx);
+  void reset();
+  // Counts since the last reset()
+  StatusCounts getThreadCounts(int threadIdx);
+  StatusCounts getTotalCounts();
+  long getNumCombinationsChecked();
+  double getElapsedSec();
+
+  private:
+  int nThreads_;
+  std::unique_ptr<ThreadStatus[]> threadStatusArr_;
+  // Protects the snapshot taken by reset()
+  std::mutex mutex_;
+  std::vector<StatusCounts> resetCountsVec_;
+  // Total checks at the last reset(), for getNumCombinationsChecked()
+  std::atomic<long> resetNCombinationsChecked_;
+  std::chrono::steady_clock::time_point resetTime_;
 };
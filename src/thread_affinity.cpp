@@ -0,0 +1,54 @@
+#include <thread>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "thread_affinity.h"
+
+int getNumCores()
+{
+  auto nCores = static_cast<int>(std::thread::hardware_concurrency());
+  return nCores > 0 ? nCores : 1;
+}
+
+#if defined(_WIN32)
+
+bool pinCurrentThread(int firstCoreIdx, int nCores)
+{
+  DWORD_PTR mask = 0;
+  for (int i = firstCoreIdx; i < firstCoreIdx + nCores; ++i) {
+    if (i < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+      mask |= static_cast<DWORD_PTR>(1) << i;
+    }
+  }
+  return mask && SetThreadAffinityMask(GetCurrentThread(), mask);
+}
+
+#elif defined(__linux__)
+
+bool pinCurrentThread(int firstCoreIdx, int nCores)
+{
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (int i = firstCoreIdx; i < firstCoreIdx + nCores; ++i) {
+    if (i < CPU_SETSIZE) {
+      CPU_SET(i, &cpuSet);
+    }
+  }
+  return CPU_COUNT(&cpuSet)
+         && !pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+}
+
+#else
+
+// macOS only supports affinity hints, which are not worth the trouble here.
+bool pinCurrentThread(int, int)
+{
+  return false;
+}
+
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+
+// Number of logical cores, at least 1
+int getNumCores();
+// Restrict the calling thread to the cores firstCoreIdx to
+// firstCoreIdx + nCores - 1. Memory that the thread allocates after this is
+// then placed on the NUMA node of those cores by the OS first touch policy.
+// Return false if pinning is not supported on the platform or failed.
+bool pinCurrentThread(int firstCoreIdx, int nCores);
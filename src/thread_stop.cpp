@@ -2,17 +2,69 @@
 
 #include "thread_stop.h"
 
-ThreadStop::ThreadStop() : lock_(mutex_, std::defer_lock)
+//
+// ThreadStop
+//
+
+ThreadStop::ThreadStop() : isStopped_(false)
 {
 }
 
 void ThreadStop::stop()
 {
-  assert(!lock_.owns_lock());
-  lock_.lock();
+  assert(!isStopped());
+  // Setting the flag with mutex_ held ensures that a thread in wait() is either
+  // blocked and gets the notification, or has not yet checked the flag.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    isStopped_.store(true, std::memory_order_relaxed);
+  }
+  cv_.notify_all();
+}
+
+bool ThreadStop::isStopped() const
+{
+  return isStopped_.load(std::memory_order_relaxed);
+}
+
+void ThreadStop::wait()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&]() { return isStopped(); });
+}
+
+//
+// LayoutGeneration
+//
+
+LayoutGeneration::LayoutGeneration() : generation_(0)
+{
+}
+
+unsigned long LayoutGeneration::advance()
+{
+  return generation_.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+unsigned long LayoutGeneration::get() const
+{
+  return generation_.load(std::memory_order_relaxed);
+}
+
+//
+// CancellationToken
+//
+
+CancellationToken::CancellationToken(
+    const ThreadStop& threadStop, const LayoutGeneration& layoutGeneration,
+    unsigned long generation)
+  : threadStop_(threadStop),
+    layoutGeneration_(layoutGeneration),
+    generation_(generation)
+{
 }
 
-bool ThreadStop::isStopped()
+bool CancellationToken::isCancelled() const
 {
-  return lock_.owns_lock();
+  return threadStop_.isStopped() || layoutGeneration_.get() != generation_;
 }
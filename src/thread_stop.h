@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <thread>
 
@@ -8,9 +10,44 @@ class ThreadStop
   public:
   ThreadStop();
   void stop();
-  bool isStopped();
+  bool isStopped() const;
+  // Block until stop() is called
+  void wait();
 
   private:
+  std::atomic<bool> isStopped_;
   std::mutex mutex_;
-  std::unique_lock<std::mutex> lock_;
+  std::condition_variable cv_;
+};
+
+// Counts the changes to the input layout. A router thread records the
+// generation of the input layout it copies, and its routing is obsolete as
+// soon as the generation moves on.
+class LayoutGeneration
+{
+  public:
+  LayoutGeneration();
+  // Call with the input layout locked
+  unsigned long advance();
+  unsigned long get() const;
+
+  private:
+  std::atomic<unsigned long> generation_;
+};
+
+// Tells a router that it should give up, because the threads are being
+// stopped or the input layout has changed. Checking is a relaxed atomic load
+// of each, so it can be done after every route without taking any lock.
+class CancellationToken
+{
+  public:
+  CancellationToken(
+      const ThreadStop& threadStop, const LayoutGeneration& layoutGeneration,
+      unsigned long generation);
+  bool isCancelled() const;
+
+  private:
+  const ThreadStop& threadStop_;
+  const LayoutGeneration& layoutGeneration_;
+  unsigned long generation_;
 };
@@ -1,33 +1,153 @@
+#include <algorithm>
+#include <climits>
+
 #include <fmt/format.h>
 
 #include "router.h"
 #include "ucs.h"
 
+//
+// ExploreStateGrid
+//
+
+ExploreStateGrid::ExploreStateGrid() : generation_(0)
+{
+}
+
+void ExploreStateGrid::reset(int gridW, int gridH)
+{
+  auto size = static_cast<size_t>(gridW * gridH * 2);
+  if (stateVec_.size() != size) {
+    stateVec_.assign(size, StampedState{ 0, ExploreState::Unseen });
+    generation_ = 0;
+  }
+  if (++generation_ == 0) {
+    // Generation wrapped around. Clear the stamps so that old entries can't
+    // be mistaken for entries in the new generation.
+    stateVec_.assign(size, StampedState{ 0, ExploreState::Unseen });
+    generation_ = 1;
+  }
+}
+
+ExploreState ExploreStateGrid::get(int idx, bool isWireLayer)
+{
+  const auto& s = stateVec_[idx * 2 + (isWireLayer ? 1 : 0)];
+  return s.generation == generation_ ? s.state : ExploreState::Unseen;
+}
+
+void ExploreStateGrid::set(int idx, bool isWireLayer, ExploreState state)
+{
+  stateVec_[idx * 2 + (isWireLayer ? 1 : 0)] = { generation_, state };
+}
+
+//
+// FrontierPri
+//
+
+void FrontierPri::clear()
+{
+  c.clear();
+}
+
+//
+// SearchTree
+//
+
+void SearchTree::reset(int gridW, int gridH, const Settings& settings)
+{
+  exploreStateGrid.reset(gridW, gridH);
+  auto nVias = static_cast<size_t>(gridW * gridH);
+  if (viaCostVec.size() != nVias) {
+    viaCostVec.resize(nVias);
+  }
+  if (parentIdxVec.size() != nVias * 2) {
+    parentIdxVec.resize(nVias * 2);
+  }
+  frontierPri.clear();
+  if (settings.use_bucket_queue) {
+    // Keys increase by at most one edge cost per step for Dijkstra. For A*, the
+    // estimate can also change by up to one edge cost per step.
+    int maxEdgeCost = std::max(
+        settings.wire_cost, std::max(settings.strip_cost, settings.via_cost));
+    // With run edges, a single step can cover a whole strip or wire.
+    int maxStepCost = maxEdgeCost;
+    if (settings.use_run_edges && !settings.use_bidirectional) {
+      maxStepCost += std::max(
+          gridW * settings.wire_cost, gridH * settings.strip_cost);
+    }
+    bucketQueue.reset(
+        gridW * gridH * 2, settings.use_astar ? 2 * maxStepCost : maxStepCost);
+  }
+}
+
+//
+// SearchWorkspace
+//
+
+SearchWorkspace::SearchWorkspace() : nSearches(0), nExpandedNodes(0)
+{
+}
+
+void SearchWorkspace::reset(int gridW, int gridH, const Settings& settings)
+{
+  forwardTree.reset(gridW, gridH, settings);
+  if (settings.use_bidirectional) {
+    backwardTree.reset(gridW, gridH, settings);
+  }
+  routeStepVec.clear();
+}
+
+//
+// UniformCostSearch
+//
+
 UniformCostSearch::UniformCostSearch(
     Router& router, Layout& layout, Nets& nets, Via& shortcutEndVia,
-    const StartEndVia& viaStartEnd)
+    const StartEndVia& viaStartEnd, SearchWorkspace& workspace)
   : router_(router),
     layout_(layout),
     nets_(nets),
     shortcutEndVia_(shortcutEndVia),
-    viaStartEnd_(viaStartEnd)
+    viaStartEnd_(viaStartEnd),
+    forwardTree_(workspace.forwardTree),
+    backwardTree_(workspace.backwardTree),
+    tree_(&workspace.forwardTree),
+    otherTree_(nullptr),
+    routeStepVec_(workspace.routeStepVec),
+    nExpandedNodes_(workspace.nExpandedNodes),
+    meetCost_(INT_MAX),
+    meetNodeIdx_(-1)
 {
-  viaCostVec_ = CostViaVec(layout_.gridW * layout_.gridH);
+  workspace.reset(layout_.gridW(), layout_.gridH(), layout_.settings());
+  ++workspace.nSearches;
 }
 
-RouteStepVec UniformCostSearch::findLowestCostRoute()
+// The returned route is stored in the SearchWorkspace and is only valid until
+// the next search. It is empty if no route was found.
+const RouteStepVec& UniformCostSearch::findLowestCostRoute()
 {
   shortcutEndVia_ = viaStartEnd_.end;
+  if (layout_.settings().use_bidirectional) {
+    bool foundRoute = findCostsBidirectional();
+    switchTree(forwardTree_, nullptr);
+#ifndef NDEBUG
+    layout_.diagCostVec = getDiagCostVec();
+#endif
+    if (foundRoute) {
+      return backtraceBidirectionalRoute();
+    }
+    return routeStepVec_;
+  }
   bool foundRoute = findCosts(shortcutEndVia_);
 #ifndef NDEBUG
-  layout_.diagCostVec = viaCostVec_;
+  layout_.diagCostVec = getDiagCostVec();
 #endif
   if (foundRoute) {
     return backtraceLowestCostRoute(
         StartEndVia(viaStartEnd_.start, shortcutEndVia_));
   }
   else {
-    return RouteStepVec();
+    return routeStepVec_;
   }
 }
 
@@ -49,21 +169,36 @@ RouteStepVec UniformCostSearch::findLowestCostRoute()
 //           frontier.add(n)
 //         'else if' n is in frontier with higher cost
 //           replace existing node with n
+//
+// With the default binary heap frontier, replacing a node in the frontier is
+// done by pushing a duplicate with the lower cost and skipping the stale entry
+// when it is popped after the node has been explored. With
+// Settings::use_bucket_queue, the frontier is a BucketQueue, which supports
+// decreasing the key of a node in place.
+//
+// With Settings::use_astar, the frontier is ordered by the cost so far plus
+// estimateRemainingCost(), which turns the search into A*. The estimate is
+// consistent, so the first time the target is popped, its cost is still the
+// lowest possible.
+//
+// With Settings::use_run_edges, see exploreRun().
 
 bool UniformCostSearch::findCosts(Via& shortcutEndVia)
 {
-  Settings& settings = layout_.settings;
+  const Settings& settings = layout_.settings();
 
   auto start = LayerVia(viaStartEnd_.start, false);
   auto end = LayerVia(viaStartEnd_.end, false);
 
   setCost(start, 0);
+  tree_->parentIdxVec[nodeIdx(start)] = -1;
 
-  frontierPri.push(LayerCostVia(start, 0));
-  frontierSet.insert(LayerCostVia(start, 0));
+  pushFrontier(start, 0, false);
+  setState(start, ExploreState::Frontier);
 
   while (true) {
-    if (!frontierPri.size()) {
+    LayerVia nodeVia;
+    if (!popFrontier(nodeVia)) {
       //#ifndef NDEBUG
       //      layout_.errorStringVec.push_back(fmt::format("Debug:
       //      UniformCostSearch::findCosts() No route found"));
@@ -74,39 +209,195 @@ bool UniformCostSearch::findCosts(Via& shortcutEndVia)
       return false;
     }
 
-    LayerCostVia node = frontierPri.top();
-    frontierPri.pop();
-    frontierSet.erase(node);
-
-    node.cost = getCost(node);
+    LayerCostVia node(nodeVia, getCost(nodeVia));
 
     if (router_.isTarget(node, end.via)) {
 #ifndef NDEBUG
-      layout_.diagCostVec = viaCostVec_;
+      layout_.diagCostVec = getDiagCostVec();
 #endif
       return true;
     }
-    exploredSet.insert(node);
+    setState(node, ExploreState::Explored);
     // Only nodes that pass isAvailable() can become <node> here, from which
     // new exploration can take place.
-    if (node.isWireLayer) {
-      exploreNeighbour(node, LayerCostVia(stepLeft(node), settings.wire_cost));
-      exploreNeighbour(node, LayerCostVia(stepRight(node), settings.wire_cost));
-      exploreNeighbour(node, LayerCostVia(stepToStrip(node), settings.via_cost));
+    if (settings.use_run_edges) {
+      exploreRun(node);
     }
     else {
-      exploreNeighbour(node, LayerCostVia(stepUp(node), settings.strip_cost));
-      exploreNeighbour(node, LayerCostVia(stepDown(node), settings.strip_cost));
-      exploreNeighbour(node, LayerCostVia(stepToWire(node), settings.via_cost));
-
-      // Wire jumps
-      const auto& wireToVia = router_.wireToViaRef(node.via);
-      if (wireToVia.isValid) {
-        exploreFrontier(
-            node,
-            LayerCostVia(LayerVia(wireToVia.via, false), settings.wire_cost));
-      }
+      expandNode(node);
+    }
+  }
+}
+
+// With Settings::use_bidirectional, a search tree is grown from each end of
+// the route, always expanding the tree whose frontier holds the lowest cost.
+// Whenever one tree reaches a node that the other tree has also reached, the
+// route through that node is a candidate, and the lowest cost candidate is
+// kept. Once the lowest costs in the two frontiers add up to no less than the
+// best candidate, no route that has not been seen yet can be cheaper, and the
+// search stops. Each tree then typically covers a region of about half the
+// radius of the region covered by the unidirectional search.
+//
+// Costs and availability are the same in both directions along each edge, so
+// the backward tree explores its neighbours the same way as the forward tree.
+// The frontiers are ordered by plain costs here, so A* and run edges only
+// apply to the unidirectional search.
+bool UniformCostSearch::findCostsBidirectional()
+{
+  auto start = LayerVia(viaStartEnd_.start, false);
+  auto end = LayerVia(viaStartEnd_.end, false);
+
+  meetCost_ = INT_MAX;
+  meetNodeIdx_ = -1;
+
+  switchTree(backwardTree_, &forwardTree_);
+  setCost(end, 0);
+  tree_->parentIdxVec[nodeIdx(end)] = -1;
+  pushFrontier(end, 0, false);
+  setState(end, ExploreState::Frontier);
+
+  switchTree(forwardTree_, &backwardTree_);
+  setCost(start, 0);
+  tree_->parentIdxVec[nodeIdx(start)] = -1;
+  pushFrontier(start, 0, false);
+  setState(start, ExploreState::Frontier);
+
+  if ((start.via == end.via).all()) {
+    meetCost_ = 0;
+    meetNodeIdx_ = nodeIdx(start);
+    return true;
+  }
+
+  while (true) {
+    int forwardKey;
+    int backwardKey;
+    switchTree(forwardTree_, &backwardTree_);
+    bool hasForward = peekFrontierKey(forwardKey);
+    switchTree(backwardTree_, &forwardTree_);
+    bool hasBackward = peekFrontierKey(backwardKey);
+    // When one tree has run out of nodes, every node it can reach has been
+    // explored, so any meeting point has already been seen.
+    if (!hasForward || !hasBackward) {
+      return meetCost_ != INT_MAX;
+    }
+    if (meetCost_ != INT_MAX && forwardKey + backwardKey >= meetCost_) {
+      return true;
+    }
+    if (forwardKey <= backwardKey) {
+      switchTree(forwardTree_, &backwardTree_);
+    }
+    LayerVia nodeVia;
+    popFrontier(nodeVia);
+    LayerCostVia node(nodeVia, getCost(nodeVia));
+    setState(node, ExploreState::Explored);
+    expandNode(node);
+  }
+}
+
+void UniformCostSearch::expandNode(LayerCostVia& node)
+{
+  ++nExpandedNodes_;
+  const Settings& settings = layout_.settings();
+  if (node.isWireLayer) {
+    exploreNeighbour(node, LayerCostVia(stepLeft(node), settings.wire_cost));
+    exploreNeighbour(node, LayerCostVia(stepRight(node), settings.wire_cost));
+  }
+  else {
+    exploreNeighbour(node, LayerCostVia(stepUp(node), settings.strip_cost));
+    exploreNeighbour(node, LayerCostVia(stepDown(node), settings.strip_cost));
+  }
+  exploreLayerExits(node);
+}
+
+void UniformCostSearch::switchTree(SearchTree& tree, SearchTree* otherTree)
+{
+  tree_ = &tree;
+  otherTree_ = otherTree;
+}
+
+// Explore the neighbours that are reached by leaving the current run: through
+// to the other layer and, on the strip layer, wire jumps.
+void UniformCostSearch::exploreLayerExits(LayerCostVia& node)
+{
+  const Settings& settings = layout_.settings();
+  if (node.isWireLayer) {
+    exploreNeighbour(node, LayerCostVia(stepToStrip(node), settings.via_cost));
+  }
+  else {
+    exploreNeighbour(node, LayerCostVia(stepToWire(node), settings.via_cost));
+
+    // Wire jumps
+    const auto& wireToVia = router_.wireToViaRef(node.via);
+    if (wireToVia.isValid) {
+      exploreFrontier(
+          node,
+          LayerCostVia(LayerVia(wireToVia.via, false), settings.wire_cost));
+    }
+  }
+}
+
+// A strip is a vertical conductor and a wire is a horizontal conductor, and
+// the cost of following either is linear in the distance. So, instead of
+// moving one via at a time through the frontier, the whole unobstructed run
+// of vias on the layer of a popped node is treated as a single compound edge.
+// The vias along the run are given their costs directly and marked as
+// Scanned, without entering the frontier. Only the vias that are reached by
+// leaving the run (and the target) enter the frontier.
+//
+// A Scanned via may later be reached at a lower cost, either along the run
+// from another node or from the other layer, in which case its cost and
+// exits are updated again. Since every cost improvement is propagated this
+// way, the search finds the same lowest costs as when stepping one via at a
+// time, so the route costs don't change.
+//
+// For the statistics, the popped node and each scanned via count as expanded
+// nodes, since the layer exits of each are explored.
+void UniformCostSearch::exploreRun(LayerCostVia& node)
+{
+  ++nExpandedNodes_;
+  const Settings& settings = layout_.settings();
+  exploreLayerExits(node);
+  if (node.isWireLayer) {
+    exploreRunDirection(node, Via(-1, 0), settings.wire_cost);
+    exploreRunDirection(node, Via(+1, 0), settings.wire_cost);
+  }
+  else {
+    exploreRunDirection(node, Via(0, -1), settings.strip_cost);
+    exploreRunDirection(node, Via(0, +1), settings.strip_cost);
+  }
+}
+
+void UniformCostSearch::exploreRunDirection(
+    const LayerCostVia& node, const Via& step, int stepCost)
+{
+  LayerCostVia prev = node;
+  while (true) {
+    LayerCostVia n(
+        LayerVia(prev.via + step, prev.isWireLayer), prev.cost + stepCost);
+    if (!router_.isAvailable(n, viaStartEnd_.start, shortcutEndVia_)) {
+      break;
+    }
+    auto state = getState(n);
+    // The rest of the run already has costs that are as low or lower.
+    if (state != ExploreState::Unseen && getCost(n) <= n.cost) {
+      break;
+    }
+    setCost(n);
+    tree_->parentIdxVec[nodeIdx(n)] = nodeIdx(prev);
+    if (state == ExploreState::Frontier) {
+      pushFrontier(n, frontierKey(n), true);
     }
+    else if (router_.isTarget(n, viaStartEnd_.end)) {
+      // The search ends when the target is popped from the frontier.
+      pushFrontier(n, frontierKey(n), false);
+      setState(n, ExploreState::Frontier);
+    }
+    else {
+      setState(n, ExploreState::Scanned);
+    }
+    exploreLayerExits(n);
+    ++nExpandedNodes_;
+    prev = n;
   }
 }
 
@@ -119,128 +410,225 @@ void UniformCostSearch::exploreNeighbour(LayerCostVia& node, LayerCostVia n)
 
 void UniformCostSearch::exploreFrontier(LayerCostVia& node, LayerCostVia n)
 {
-  if (exploredSet.count(n)) {
+  auto state = getState(n);
+  if (state == ExploreState::Explored) {
     return;
   }
   n.cost += node.cost;
-  setCost(n);
-  auto frontierN = frontierSet.find(n);
-  if (frontierN == frontierSet.end()) {
-    frontierPri.push(n);
-    frontierSet.insert(n);
+  if (state == ExploreState::Unseen || n.cost < getCost(n)) {
     setCost(n);
+    tree_->parentIdxVec[nodeIdx(n)] = nodeIdx(node);
+    pushFrontier(n, frontierKey(n), state == ExploreState::Frontier);
+    setState(n, ExploreState::Frontier);
+    if (otherTree_ && getState(*otherTree_, n) != ExploreState::Unseen) {
+      int meetCost = n.cost + getCost(*otherTree_, n);
+      if (meetCost < meetCost_) {
+        meetCost_ = meetCost;
+        meetNodeIdx_ = nodeIdx(n);
+      }
+    }
+  }
+}
+
+int UniformCostSearch::frontierKey(const LayerCostVia& n)
+{
+  if (layout_.settings().use_astar && !otherTree_) {
+    return n.cost + estimateRemainingCost(n);
+  }
+  return n.cost;
+}
+
+void UniformCostSearch::pushFrontier(
+    const LayerVia& via, int key, bool isInFrontier)
+{
+  if (layout_.settings().use_bucket_queue) {
+    if (isInFrontier) {
+      tree_->bucketQueue.decreaseKey(nodeIdx(via), key);
+    }
+    else {
+      tree_->bucketQueue.push(nodeIdx(via), key);
+    }
   }
   else {
-    auto frontierCost = getCost(*frontierN);
-    if (frontierCost > n.cost) {
-      node.cost = n.cost;
-      setCost(node);
+    tree_->frontierPri.push(LayerCostVia(via, key));
+  }
+}
+
+// Return false if the frontier is empty.
+bool UniformCostSearch::popFrontier(LayerVia& via)
+{
+  if (layout_.settings().use_bucket_queue) {
+    if (tree_->bucketQueue.isEmpty()) {
+      return false;
+    }
+    via = nodeVia(tree_->bucketQueue.pop());
+    return true;
+  }
+  while (tree_->frontierPri.size()) {
+    via = tree_->frontierPri.top();
+    tree_->frontierPri.pop();
+    // Skip stale duplicates of nodes that were reached again at lower cost.
+    if (getState(via) != ExploreState::Explored) {
+      return true;
     }
   }
+  return false;
 }
 
-RouteStepVec UniformCostSearch::backtraceLowestCostRoute(
-    const StartEndVia& viaStartEnd)
+// Get the lowest key in the frontier without removing the node. Return false
+// if the frontier is empty.
+bool UniformCostSearch::peekFrontierKey(int& key)
 {
-  int routeCost = 0;
-  auto start = LayerVia(viaStartEnd.start, false);
-  auto end = LayerVia(viaStartEnd.end, false);
-  RouteStepVec routeStepVec;
-  auto c = end;
-  routeStepVec.push_back(c);
-
-  // If there is an error in the uniform cost search, it typically causes the
-  // backtrace to get stuck. We check
-  // for the condition and return diagnostics information.
-  int checkStuckCnt = 0;
-
-  while (!((c.via == start.via).all() && c.isWireLayer == start.isWireLayer)) {
-    if (checkStuckCnt++ > layout_.gridW * layout_.gridH) {
-      layout_.errorStringVec.push_back(
-          fmt::format("Error: backtraceLowestCostRoute() stuck at {}", c.str()));
-      layout_.diagStartVia = start.via;
-      layout_.diagEndVia = end.via;
-      layout_.diagRouteStepVec = routeStepVec;
-      layout_.hasError = true;
-      break;
+  if (layout_.settings().use_bucket_queue) {
+    if (tree_->bucketQueue.isEmpty()) {
+      return false;
+    }
+    key = tree_->bucketQueue.topKey();
+    return true;
+  }
+  while (tree_->frontierPri.size()) {
+    const auto& via = tree_->frontierPri.top();
+    if (getState(via) != ExploreState::Explored) {
+      key = via.cost;
+      return true;
     }
+    tree_->frontierPri.pop();
+  }
+  return false;
+}
 
-    LayerVia n = c;
-    if (c.isWireLayer) {
-      auto nLeft = stepLeft(c);
-      if (c.via.x() > 0 && getCost(nLeft) < getCost(n)) {
-        n = nLeft;
-      }
-      auto nRight = stepRight(c);
-      if (c.via.x() < layout_.gridW - 1 && getCost(nRight) < getCost(n)) {
-        n = nRight;
-      }
-      auto nStrip = stepToStrip(c);
-      if (getCost(nStrip) < getCost(n)) {
-        n = nStrip;
-      }
+int UniformCostSearch::nodeIdx(const LayerVia& via)
+{
+  return layout_.idx(via.via) * 2 + (via.isWireLayer ? 1 : 0);
+}
+
+LayerVia UniformCostSearch::nodeVia(int nodeIdx)
+{
+  int i = nodeIdx / 2;
+  return LayerVia(Via(i % layout_.gridW(), i / layout_.gridW()), nodeIdx & 1);
+}
+
+// Lower bound for the cost of reaching the target from via, for A*.
+//
+// - Vertical movement is only possible on the strip layer, one strip_cost per
+// step.
+// - Horizontal movement is only possible on the wire layer, one wire_cost per
+// step, and requires going through to the wire layer and back. Wire jumps
+// along existing wires cover any horizontal distance for a single wire_cost,
+// so when there are wire jumps, wire_cost is the only safe bound.
+// - A route always ends on the strip layer, so a via on the wire layer must
+// at least go through to the strip layer.
+int UniformCostSearch::estimateRemainingCost(const LayerVia& via)
+{
+  const Settings& settings = layout_.settings();
+  auto d = (via.via - viaStartEnd_.end).abs();
+  int cost = d.y() * settings.strip_cost;
+  if (via.isWireLayer) {
+    cost += settings.via_cost;
+  }
+  if (d.x()) {
+    if (router_.hasWireJumps()) {
+      cost += settings.wire_cost;
     }
     else {
-      auto nUp = stepUp(c);
-      if (c.via.y() > 0 && getCost(nUp) < getCost(n)) {
-        n = nUp;
-      }
-      auto nDown = stepDown(c);
-      if (c.via.y() < layout_.gridH - 1 && getCost(nDown) < getCost(n)) {
-        n = nDown;
-      }
-      auto nWire = stepToWire(c);
-      if (getCost(nWire) < getCost(n)) {
-        n = nWire;
-      }
-
-      const auto& wireToVia = router_.wireToViaRef(c.via);
-      if (wireToVia.isValid) {
-        auto nWireJump = LayerVia(wireToVia.via, false);
-        if (getCost(nWireJump) < getCost(n)) {
-          // When we jump, we have to record the steps.
-          // Through to wire layer.
-          routeStepVec.push_back(LayerVia(c.via, true));
-          int x1 = c.via.x();
-          int x2 = nWireJump.via.x();
-          int step = x1 > x2 ? -1 : 1;
-          for (int x = x1; x != x2; x += step) {
-            routeStepVec.push_back(LayerVia(Via(x, c.via.y()), true));
-          }
-          if (x1 != x2) {
-            routeStepVec.push_back(LayerVia(Via(x2, c.via.y()), true));
-          }
-          // Final step through to strip layer is stored outside the
-          // conditional.
-          n = nWireJump;
-        }
+      cost += d.x() * settings.wire_cost;
+      if (!via.isWireLayer) {
+        cost += 2 * settings.via_cost;
       }
     }
-    routeCost += getCost(c) - getCost(n);
-    c = n;
-    routeStepVec.push_back(c);
   }
-  layout_.cost += routeCost;
+  return cost;
+}
+
+// Follow the predecessors recorded by findCosts() from the end back to the
+// start. Wire jumps are expanded to the steps along the wire they follow.
+const RouteStepVec& UniformCostSearch::backtraceLowestCostRoute(
+    const StartEndVia& viaStartEnd)
+{
+  auto end = LayerVia(viaStartEnd.end, false);
+  auto& routeStepVec = routeStepVec_;
+  appendTreeRoute(*tree_, nodeIdx(end));
+  layout_.cost += getCost(end);
   std::reverse(routeStepVec.begin(), routeStepVec.end());
 
 #ifndef NDEBUG
   layout_.diagRouteStepVec = routeStepVec;
-  layout_.diagStartVia = ValidVia(start.via, true);
+  layout_.diagStartVia = ValidVia(viaStartEnd.start, true);
   layout_.diagEndVia = ValidVia(end.via, true);
 #endif
 
   return routeStepVec;
 }
 
+// Join the routes from the meeting point back to the roots of the two trees
+// found by findCostsBidirectional().
+const RouteStepVec& UniformCostSearch::backtraceBidirectionalRoute()
+{
+  auto& routeStepVec = routeStepVec_;
+  // Meeting point to end, reversed, without the meeting point itself.
+  appendTreeRoute(backwardTree_, meetNodeIdx_);
+  std::reverse(routeStepVec.begin(), routeStepVec.end());
+  routeStepVec.pop_back();
+  // Meeting point to start.
+  appendTreeRoute(forwardTree_, meetNodeIdx_);
+  std::reverse(routeStepVec.begin(), routeStepVec.end());
+  layout_.cost += meetCost_;
+
+#ifndef NDEBUG
+  layout_.diagRouteStepVec = routeStepVec;
+  layout_.diagStartVia = ValidVia(viaStartEnd_.start, true);
+  layout_.diagEndVia = ValidVia(viaStartEnd_.end, true);
+#endif
+
+  return routeStepVec;
+}
+
+// Append the steps from nodeIdx back to the root of the tree. Wire jumps are
+// expanded to the steps along the wire they follow.
+void UniformCostSearch::appendTreeRoute(SearchTree& tree, int nodeIdx)
+{
+  auto& routeStepVec = routeStepVec_;
+  int i = nodeIdx;
+  while (true) {
+    auto c = nodeVia(i);
+    routeStepVec.push_back(c);
+    int parentIdx = tree.parentIdxVec[i];
+    if (parentIdx == -1) {
+      break;
+    }
+    auto p = nodeVia(parentIdx);
+    // Steps on the strip layer are vertical, so a step between two vias on the
+    // strip layer that changes x is a wire jump.
+    if (!c.isWireLayer && !p.isWireLayer && c.via.x() != p.via.x()) {
+      int x1 = c.via.x();
+      int x2 = p.via.x();
+      int step = x1 > x2 ? -1 : 1;
+      for (int x = x1; x != x2 + step; x += step) {
+        routeStepVec.push_back(LayerVia(Via(x, c.via.y()), true));
+      }
+    }
+    i = parentIdx;
+  }
+}
+
 int UniformCostSearch::getCost(const LayerVia& viaLayer)
 {
+  return getCost(*tree_, viaLayer);
+}
+
+int UniformCostSearch::getCost(SearchTree& tree, const LayerVia& viaLayer)
+{
+  // Costs left over from earlier searches are not cleared.
+  if (getState(tree, viaLayer) == ExploreState::Unseen) {
+    return INT_MAX;
+  }
   int cost;
   int i = layout_.idx(viaLayer.via);
   if (viaLayer.isWireLayer) {
-    cost = viaCostVec_[i].wireCost;
+    cost = tree.viaCostVec[i].wireCost;
   }
   else {
-    cost = viaCostVec_[i].stripCost;
+    cost = tree.viaCostVec[i].stripCost;
   }
   return cost;
 }
@@ -249,10 +637,10 @@ void UniformCostSearch::setCost(const LayerVia& viaLayer, int cost)
 {
   int i = layout_.idx(viaLayer.via);
   if (viaLayer.isWireLayer) {
-    viaCostVec_[i].wireCost = cost;
+    tree_->viaCostVec[i].wireCost = cost;
   }
   else {
-    viaCostVec_[i].stripCost = cost;
+    tree_->viaCostVec[i].stripCost = cost;
   }
 }
 
@@ -261,6 +649,40 @@ void UniformCostSearch::setCost(const LayerCostVia& viaLayerCost)
   setCost(viaLayerCost, viaLayerCost.cost);
 }
 
+#ifndef NDEBUG
+CostViaVec UniformCostSearch::getDiagCostVec()
+{
+  CostViaVec costVec(tree_->viaCostVec.size());
+  for (int y = 0; y < layout_.gridH(); ++y) {
+    for (int x = 0; x < layout_.gridW(); ++x) {
+      Via v(x, y);
+      auto& c = costVec[layout_.idx(v)];
+      c.wireCost = getCost(LayerVia(v, true));
+      c.stripCost = getCost(LayerVia(v, false));
+    }
+  }
+  return costVec;
+}
+#endif
+
+ExploreState UniformCostSearch::getState(const LayerVia& viaLayer)
+{
+  return getState(*tree_, viaLayer);
+}
+
+ExploreState UniformCostSearch::getState(
+    SearchTree& tree, const LayerVia& viaLayer)
+{
+  return tree.exploreStateGrid.get(
+      layout_.idx(viaLayer.via), viaLayer.isWireLayer);
+}
+
+void UniformCostSearch::setState(const LayerVia& viaLayer, ExploreState state)
+{
+  tree_->exploreStateGrid.set(
+      layout_.idx(viaLayer.via), viaLayer.isWireLayer, state);
+}
+
 LayerVia UniformCostSearch::stepLeft(const LayerVia& v)
 {
   return LayerVia(v.via + Via(-1, 0), v.isWireLayer);
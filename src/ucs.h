@@ -1,18 +1,88 @@
 #pragma once
 
 #include <queue>
-//#include <set>
-#include <unordered_set>
+#include <vector>
 
+#include "bucket_queue.h"
 #include "layout.h"
 #include "nets.h"
 #include "via.h"
 
-typedef std::priority_queue<LayerCostVia> FrontierPri;
-// typedef std::set<LayerVia> FrontierSet;
-// typedef std::set<LayerVia> ExploredSet;
-typedef std::unordered_set<LayerVia> FrontierSet;
-typedef std::unordered_set<LayerVia> ExploredSet;
+// Frontier and explored sets for the Uniform Cost Search, stored as flat
+// per-via state on both layers and indexed by Layout::idx(). An entry is only
+// valid if its generation matches the current generation, so a new search
+// starts by bumping the generation instead of clearing or reallocating.
+
+enum class ExploreState : unsigned char
+{
+  Unseen,
+  Frontier,
+  Explored,
+  Scanned
+};
+
+class ExploreStateGrid
+{
+  public:
+  ExploreStateGrid();
+  void reset(int gridW, int gridH);
+  ExploreState get(int idx, bool isWireLayer);
+  void set(int idx, bool isWireLayer, ExploreState);
+
+  private:
+  struct StampedState
+  {
+    unsigned int generation;
+    ExploreState state;
+  };
+  std::vector<StampedState> stateVec_;
+  unsigned int generation_;
+};
+
+// Binary heap frontier that can be cleared without releasing its storage.
+
+class FrontierPri : public std::priority_queue<LayerCostVia>
+{
+  public:
+  void clear();
+};
+
+// Buffers used by the Uniform Cost Search. Each router thread creates a single
+// workspace and passes it to every Router it creates, so the buffers outlive
+// individual routes and layouts and the search does not allocate in steady
+// state. reset() is O(1) unless the grid size changes. Costs are only valid
+// for vias that are in the frontier or explored in the current generation of
+// the ExploreStateGrid.
+//
+// A SearchTree holds the state for a search grown from one end of a route.
+// The bidirectional search uses one tree from each end.
+
+typedef std::vector<int> ParentIdxVec;
+
+class SearchTree
+{
+  public:
+  void reset(int gridW, int gridH, const Settings& settings);
+  ExploreStateGrid exploreStateGrid;
+  CostViaVec viaCostVec;
+  FrontierPri frontierPri;
+  BucketQueue bucketQueue;
+  // Predecessor of each node on the lowest cost route found to it so far
+  ParentIdxVec parentIdxVec;
+};
+
+class SearchWorkspace
+{
+  public:
+  SearchWorkspace();
+  void reset(int gridW, int gridH, const Settings& settings);
+  SearchTree forwardTree;
+  SearchTree backwardTree;
+  RouteStepVec routeStepVec;
+  // Totals for the statistics, not cleared by reset()
+  long nSearches;
+  long nExpandedNodes;
+};
 
 class Router;
 
@@ -21,18 +91,43 @@ class UniformCostSearch
   public:
   UniformCostSearch(
       Router& router, Layout& layout, Nets& nets, Via& shortcutEndVia,
-      const StartEndVia& viaStartEnd);
-  RouteStepVec findLowestCostRoute();
+      const StartEndVia& viaStartEnd, SearchWorkspace& workspace);
+  const RouteStepVec& findLowestCostRoute();
 
   private:
   bool findCosts(Via& shortcutEndVia);
+  bool findCostsBidirectional();
   void exploreNeighbour(LayerCostVia& node, LayerCostVia n);
   void exploreFrontier(LayerCostVia& node, LayerCostVia n);
-  RouteStepVec backtraceLowestCostRoute(const StartEndVia&);
+  void exploreLayerExits(LayerCostVia& node);
+  void exploreRun(LayerCostVia& node);
+  void exploreRunDirection(
+      const LayerCostVia& node, const Via& step, int stepCost);
+  int frontierKey(const LayerCostVia&);
+  const RouteStepVec& backtraceLowestCostRoute(const StartEndVia&);
+  const RouteStepVec& backtraceBidirectionalRoute();
+  void appendTreeRoute(SearchTree& tree, int nodeIdx);
+  int estimateRemainingCost(const LayerVia&);
+
+  void pushFrontier(const LayerVia&, int key, bool isInFrontier);
+  bool popFrontier(LayerVia&);
+  bool peekFrontierKey(int& key);
+  void expandNode(LayerCostVia& node);
+  void switchTree(SearchTree& tree, SearchTree* otherTree);
+  int nodeIdx(const LayerVia&);
+  LayerVia nodeVia(int nodeIdx);
 
   int getCost(const LayerVia&);
+  int getCost(SearchTree&, const LayerVia&);
   void setCost(const LayerVia&, int cost);
   void setCost(const LayerCostVia&);
+#ifndef NDEBUG
+  CostViaVec getDiagCostVec();
+#endif
+
+  ExploreState getState(const LayerVia&);
+  ExploreState getState(SearchTree&, const LayerVia&);
+  void setState(const LayerVia&, ExploreState);
 
   LayerVia stepLeft(const LayerVia& v);
   LayerVia stepRight(const LayerVia&);
@@ -47,8 +142,15 @@ class UniformCostSearch
   Via& shortcutEndVia_;
   const StartEndVia& viaStartEnd_;
 
-  CostViaVec viaCostVec_;
-  FrontierPri frontierPri;
-  FrontierSet frontierSet;
-  ExploredSet exploredSet;
+  SearchTree& forwardTree_;
+  SearchTree& backwardTree_;
+  // The tree that is currently being grown and, for the bidirectional search,
+  // the tree grown from the other end.
+  SearchTree* tree_;
+  SearchTree* otherTree_;
+  RouteStepVec& routeStepVec_;
+  long& nExpandedNodes_;
+  // Lowest cost route found where the trees of the bidirectional search meet
+  int meetCost_;
+  int meetNodeIdx_;
 };
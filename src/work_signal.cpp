@@ -0,0 +1,33 @@
+#include "work_signal.h"
+
+WorkSignal::WorkSignal() : epoch_(0)
+{
+}
+
+void WorkSignal::notify()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++epoch_;
+  }
+  cv_.notify_all();
+}
+
+unsigned long WorkSignal::getEpoch()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return epoch_;
+}
+
+void WorkSignal::wait(unsigned long epoch)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&]() { return epoch_ != epoch; });
+}
+
+bool WorkSignal::waitFor(
+    unsigned long epoch, std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  return cv_.wait_for(lock, timeout, [&]() { return epoch_ != epoch; });
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// Wakes threads that are waiting for work to become available. Each notify()
+// starts a new epoch. A thread gets the epoch before it checks for work, and
+// if there is none, waits for the epoch to change. Work that becomes available
+// after the check is always followed by a notify(), so the wakeup is not lost.
+
+class WorkSignal
+{
+  public:
+  WorkSignal();
+  void notify();
+  unsigned long getEpoch();
+  void wait(unsigned long epoch);
+  // Return false on timeout
+  bool waitFor(unsigned long epoch, std::chrono::milliseconds timeout);
+
+  private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  unsigned long epoch_;
+};
@@ -57,12 +57,12 @@ SvgPathVec SvgWriter::writeFiles(const std::string circuitFilePath)
 svg::Document SvgWriter::initDoc(
     const std::string& svgPath, const bool drawMirrorImage)
 {
-  auto physicalWInch = VIA_DISTANCE_INCH * (layout_.gridW + (2.0 * BOARD_MARGIN));
-  auto physicalHInch = VIA_DISTANCE_INCH * (layout_.gridH + (2.0 * BOARD_MARGIN));
+  auto physicalWInch = VIA_DISTANCE_INCH * (layout_.gridW() + (2.0 * BOARD_MARGIN));
+  auto physicalHInch = VIA_DISTANCE_INCH * (layout_.gridH() + (2.0 * BOARD_MARGIN));
 
   auto virtualUpperLeft = svg::Point(-BOARD_MARGIN, -BOARD_MARGIN);
   auto virtualLowerRight =
-      svg::Point(layout_.gridW + BOARD_MARGIN, layout_.gridH + BOARD_MARGIN);
+      svg::Point(layout_.gridW() + BOARD_MARGIN, layout_.gridH() + BOARD_MARGIN);
 
   auto physicalWStr = fmt::format("{:f}in", physicalWInch);
   auto physicalHStr = fmt::format("{:f}in", physicalHInch);
@@ -104,18 +104,18 @@ void SvgWriter::drawBackground(svg::Document& doc)
 {
   svg::Polygon background(svg::Fill(WHITE), svg::Stroke(0.0, WHITE));
   background << svg::Point(-BOARD_MARGIN, -BOARD_MARGIN)
-             << svg::Point(layout_.gridW + BOARD_MARGIN, -BOARD_MARGIN)
-             << svg::Point(layout_.gridW + BOARD_MARGIN, layout_.gridH + BOARD_MARGIN)
-             << svg::Point(-BOARD_MARGIN, layout_.gridH + BOARD_MARGIN);
+             << svg::Point(layout_.gridW() + BOARD_MARGIN, -BOARD_MARGIN)
+             << svg::Point(layout_.gridW() + BOARD_MARGIN, layout_.gridH() + BOARD_MARGIN)
+             << svg::Point(-BOARD_MARGIN, layout_.gridH() + BOARD_MARGIN);
   doc << background;
 }
 
 void SvgWriter::drawBoardOutline(svg::Document& doc)
 {
   svg::Polygon border(svg::Fill(WHITE), svg::Stroke(BOARD_OUTLINE_WIDTH, BLACK));
-  border << svg::Point(-1.0, -1.0) << svg::Point(layout_.gridW, -1.0)
-         << svg::Point(layout_.gridW, layout_.gridH)
-         << svg::Point(-1.0, layout_.gridH);
+  border << svg::Point(-1.0, -1.0) << svg::Point(layout_.gridW(), -1.0)
+         << svg::Point(layout_.gridW(), layout_.gridH())
+         << svg::Point(-1.0, layout_.gridH());
   doc << border;
 }
 
@@ -125,20 +125,20 @@ void SvgWriter::drawCorners(svg::Document& doc)
       svg::Point(0, 0), CORNER_ALIGNMENT_MARKER_DIAMETER, svg::Fill(BLACK),
       svg::Stroke(CORNER_ALIGNMENT_MARKER_DIAMETER, BLACK));
   doc << svg::Circle(
-      svg::Point(layout_.gridW - 1, 0), CORNER_ALIGNMENT_MARKER_DIAMETER, svg::Fill(BLACK),
+      svg::Point(layout_.gridW() - 1, 0), CORNER_ALIGNMENT_MARKER_DIAMETER, svg::Fill(BLACK),
       svg::Stroke(CORNER_ALIGNMENT_MARKER_DIAMETER, BLACK));
   doc << svg::Circle(
-      svg::Point(layout_.gridW - 1, layout_.gridH - 1), CORNER_ALIGNMENT_MARKER_DIAMETER,
+      svg::Point(layout_.gridW() - 1, layout_.gridH() - 1), CORNER_ALIGNMENT_MARKER_DIAMETER,
       svg::Fill(BLACK), svg::Stroke(CORNER_ALIGNMENT_MARKER_DIAMETER, BLACK));
   doc << svg::Circle(
-      svg::Point(0, layout_.gridH - 1), CORNER_ALIGNMENT_MARKER_DIAMETER, svg::Fill(BLACK),
+      svg::Point(0, layout_.gridH() - 1), CORNER_ALIGNMENT_MARKER_DIAMETER, svg::Fill(BLACK),
       svg::Stroke(CORNER_ALIGNMENT_MARKER_DIAMETER, BLACK));
 }
 
 void SvgWriter::drawVias(svg::Document& doc)
 {
-  for (int y = 0; y < layout_.gridH; ++y) {
-    for (int x = 0; x < layout_.gridW; ++x) {
+  for (int y = 0; y < layout_.gridH(); ++y) {
+    for (int x = 0; x < layout_.gridW(); ++x) {
       doc << svg::Circle(
           svg::Point(x, y), VIA_DIAMETER, svg::Fill(BLACK),
           svg::Stroke(VIA_DIAMETER, BLACK));
@@ -194,6 +194,6 @@ void SvgWriter::drawTitle(svg::Document& doc, const std::string& titleStr)
 void SvgWriter::drawTitleMirror(svg::Document& doc, const std::string& titleStr)
 {
   doc << svg::Text(
-      svg::Point(layout_.gridW, -TITLE_FONT_SIZE * 2), titleStr, BLACK,
+      svg::Point(layout_.gridW(), -TITLE_FONT_SIZE * 2), titleStr, BLACK,
       svg::Font(TITLE_FONT_SIZE, TITLE_FONT_NAME));
 }